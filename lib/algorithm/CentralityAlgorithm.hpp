@@ -0,0 +1,423 @@
+#ifndef GRAPHALGORITHM_CENTRALITYALGORITHM_HPP
+#define GRAPHALGORITHM_CENTRALITYALGORITHM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "DenseSnapshot.hpp"
+#include "Graph.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryUsage.hpp"
+#include "PairHeap.hpp"
+#include "RadixHeap.hpp"
+#include "ThreadPool.hpp"
+#include "WeightTraits.hpp"
+
+/**
+ * Settings of CentralityAlgorithm::betweenness.
+ */
+struct BetweennessOptions {
+    /**
+     * True for shortest paths by edge weight (Dijkstra), false for fewest edges (BFS).
+     */
+    bool weighted = false;
+
+    /**
+     * True to divide by the number of ordered pairs of other vertices, (n - 1)(n - 2), or of
+     * unordered pairs in an undirected graph: the share of the shortest paths through a vertex.
+     */
+    bool normalized = false;
+
+    /**
+     * Number of sources drawn at random, without replacement, for an estimate; 0 (or n or more)
+     * uses every vertex and gives the exact value. See CentralityAlgorithm::samplesFor.
+     */
+    size_t samples = 0;
+    uint64_t seed = 1;
+
+    /**
+     * Threads and grain of the loop over the sources.
+     */
+    ParallelOptions parallel;
+};
+
+/**
+ * Betweenness centrality by Brandes' algorithm, exact or from sampled sources.
+ *
+ * Each source runs a BFS or Dijkstra that counts the shortest paths to every vertex, then walks
+ * the vertices back in the order they were settled to accumulate their dependencies, checking the
+ * out-edges for the ones on a shortest path instead of storing predecessor lists.
+ *
+ * The sources are split among the threads of ThreadPool::global(). A slice borrows a workspace
+ * (search arrays, heap and its own centrality sums) from a shared list and gives it back, so
+ * there are never more workspaces than threads and the sums are only merged at the end. Merging
+ * in a different order can change the last bits of the sums.
+ *
+ * Sampling k sources and scaling by n / k gives an unbiased estimate; getErrorBound tells how
+ * far it can be from the exact value, by Hoeffding's inequality.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges
+ * @tparam G graph type, directed or not
+ */
+template<class T, class W = double, class G = Graph<T, W>>
+class CentralityAlgorithm {
+public:
+    using Distance = typename WeightTraits<W>::Distance;
+    using VertexId = typename DenseSnapshot<T, W, G>::VertexId;
+    using EdgeId = typename DenseSnapshot<T, W, G>::EdgeId;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+private:
+    using Queue = std::conditional_t<std::is_unsigned_v<Distance>, RadixHeap<VertexId>, PairHeap<VertexId, Distance>>;
+
+    /**
+     * Scratch state of the searches of one thread, and the sums of the dependencies it found.
+     */
+    struct Workspace {
+        std::vector<Distance> distTo;
+        std::vector<double> paths;
+        std::vector<double> dependency;
+        std::vector<VertexId> settled;
+        std::vector<bool> marked;
+        Queue heap;
+        std::vector<double> centrality;
+
+        explicit Workspace(size_t n) : distTo(n, WeightTraits<W>::infinity()), paths(n, 0.0),
+                                       dependency(n, 0.0), marked(n, false), centrality(n, 0.0) {
+            if constexpr (!std::is_unsigned_v<Distance>)
+                PairHeap<VertexId, Distance>::minPairHeap(heap);
+        }
+    };
+
+    DenseSnapshot<T, W, G> snapshot;
+    bool positive = true;
+
+    std::vector<std::unique_ptr<Workspace>> workspaces;
+    std::vector<Workspace *> idle;
+    std::mutex borrowing;
+
+    std::vector<double> centrality;
+    size_t sourceCount = 0;
+    bool normalized = false;
+    Instrumentation recorder;
+
+    /**
+     * @brief Takes the snapshot and checks the weights, if not done yet.
+     */
+    void build();
+
+    Workspace *borrow();
+    void giveBack(Workspace *workspace);
+
+    /**
+     * @brief Adds the dependencies of every vertex on a source to the sums of the workspace, and
+     * leaves its search arrays clean for the next source.
+     */
+    void accumulate(Workspace &workspace, VertexId source, bool weighted) const;
+
+public:
+    explicit CentralityAlgorithm(G *graph);
+    void changeGraph(G *graf);
+
+    /**
+     * @brief The betweenness of every vertex: over the pairs of other vertices (s, t), the share
+     * of the shortest s-t paths going through it. An undirected graph counts each pair once.
+     *
+     * @param options Weighted or not, normalization, sample size and threads.
+     * @throw std::invalid_argument If options.weighted and an edge weight is not positive.
+     */
+    CentralityAlgorithm<T, W, G> &betweenness(const BetweennessOptions &options = BetweennessOptions());
+
+    /**
+     * @return The betweenness of the vertex after the last query, 0 if not in the graph.
+     */
+    double getCentrality(const T &vertex) const;
+
+    /**
+     * @return The count vertices of highest betweenness, highest first, ties in an unspecified
+     *         but stable order.
+     */
+    std::vector<std::pair<T, double>> getTop(size_t count) const;
+
+    /**
+     * @return The number of sources of the last query, all the vertices if it was exact.
+     */
+    size_t getSourceCount() const;
+
+    /**
+     * @brief How far the last estimate can be from the exact betweenness.
+     *
+     * With k sampled sources out of n, with probability at least confidence every vertex at once
+     * is within n / (n - 1) sqrt(ln(2n / (1 - confidence)) / 2k) of its normalized value; the
+     * bound is scaled back to the units of getCentrality.
+     *
+     * @param confidence In (0, 1).
+     * @return The additive error bound; 0 after an exact query.
+     * @throw std::invalid_argument If confidence is out of range.
+     */
+    double getErrorBound(double confidence = 0.95) const;
+
+    /**
+     * @return The number of sampled sources for which every normalized betweenness is within
+     *         epsilon with probability at least confidence, by the same bound as getErrorBound.
+     * @throw std::invalid_argument If epsilon is not positive or confidence is out of range.
+     */
+    static size_t samplesFor(size_t vertexCount, double epsilon, double confidence = 0.95);
+
+    /**
+     * @return Phase timings of the last query; the searches run on several threads and are not
+     *         counted. All zero unless built with GRAPHALGORITHM_INSTRUMENTATION.
+     */
+    const QueryStats &getStats() const;
+
+    /**
+     * @return The bytes of the snapshot, of the workspaces and of the result.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class T, class W, class G>
+CentralityAlgorithm<T, W, G>::CentralityAlgorithm(G *graph) : snapshot(graph) {}
+
+template<class T, class W, class G>
+void CentralityAlgorithm<T, W, G>::changeGraph(G *graf) {
+    snapshot.changeGraph(graf);
+}
+
+template<class T, class W, class G>
+void CentralityAlgorithm<T, W, G>::build() {
+    if (!snapshot.refresh()) return;
+
+    positive = true;
+    for (W weight : snapshot.getCsr().getWeights())
+        if (!(static_cast<Distance>(weight) > Distance(0))) positive = false;
+
+    // the workspaces are sized to the graph
+    workspaces.clear();
+    idle.clear();
+}
+
+template<class T, class W, class G>
+typename CentralityAlgorithm<T, W, G>::Workspace *CentralityAlgorithm<T, W, G>::borrow() {
+    std::lock_guard<std::mutex> guard(borrowing);
+    if (idle.empty()) {
+        workspaces.push_back(std::make_unique<Workspace>(snapshot.size()));
+        return workspaces.back().get();
+    }
+    Workspace *workspace = idle.back();
+    idle.pop_back();
+    return workspace;
+}
+
+template<class T, class W, class G>
+void CentralityAlgorithm<T, W, G>::giveBack(Workspace *workspace) {
+    std::lock_guard<std::mutex> guard(borrowing);
+    idle.push_back(workspace);
+}
+
+template<class T, class W, class G>
+void CentralityAlgorithm<T, W, G>::accumulate(Workspace &workspace, VertexId source, bool weighted) const {
+    auto &distTo = workspace.distTo;
+    auto &paths = workspace.paths;
+    auto &dependency = workspace.dependency;
+    auto &settled = workspace.settled;
+    const auto &csr = snapshot.getCsr();
+    settled.clear();
+
+    // forward: shortest path counts, vertices in the order they are settled
+    distTo[source] = Distance(0);
+    paths[source] = 1.0;
+    if (weighted) {
+        auto &marked = workspace.marked;
+        auto &heap = workspace.heap;
+        heap.clear();
+        heap.add(source, Distance(0));
+        while (!heap.isEmpty()) {
+            const VertexId u = heap.pool();
+            if (marked[u]) continue;
+            marked[u] = true;
+            settled.push_back(u);
+
+            for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+                const VertexId w = csr.getTarget(e);
+                const Distance candidate = distTo[u] + static_cast<Distance>(csr.getWeight(e));
+                if (candidate < distTo[w]) {
+                    distTo[w] = candidate;
+                    paths[w] = paths[u];
+                    heap.add(w, candidate);
+                } else if (candidate == distTo[w]) {
+                    paths[w] += paths[u];
+                }
+            }
+        }
+    } else {
+        // the settled list doubles as the BFS queue
+        settled.push_back(source);
+        for (size_t head = 0; head < settled.size(); head++) {
+            const VertexId u = settled[head];
+            const Distance next = distTo[u] + Distance(1);
+            for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+                const VertexId w = csr.getTarget(e);
+                if (distTo[w] == WeightTraits<W>::infinity()) {
+                    distTo[w] = next;
+                    settled.push_back(w);
+                }
+                if (distTo[w] == next) paths[w] += paths[u];
+            }
+        }
+    }
+
+    // backward: an out-edge is on a shortest path when it reaches its head at the head's distance
+    for (size_t i = settled.size(); i-- > 0;) {
+        const VertexId u = settled[i];
+        double sum = 0.0;
+        for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+            const VertexId w = csr.getTarget(e);
+            const Distance length = weighted ? static_cast<Distance>(csr.getWeight(e)) : Distance(1);
+            if (distTo[w] != WeightTraits<W>::infinity() && distTo[u] + length == distTo[w])
+                sum += (1.0 + dependency[w]) / paths[w];
+        }
+        dependency[u] = paths[u] * sum;
+        if (u != source) workspace.centrality[u] += dependency[u];
+    }
+
+    for (VertexId u : settled) {
+        distTo[u] = WeightTraits<W>::infinity();
+        paths[u] = 0.0;
+        dependency[u] = 0.0;
+        if (weighted) workspace.marked[u] = false;
+    }
+}
+
+template<class T, class W, class G>
+CentralityAlgorithm<T, W, G> &CentralityAlgorithm<T, W, G>::betweenness(const BetweennessOptions &options) {
+    auto query = recorder.scope();
+    build();
+    if (options.weighted && !positive)
+        throw std::invalid_argument("CentralityAlgorithm: weighted betweenness needs positive weights");
+    const size_t n = snapshot.size();
+
+    // a partial Fisher-Yates shuffle draws the sample without replacement
+    std::vector<VertexId> sources(n);
+    for (VertexId v = 0; v < n; v++) sources[v] = v;
+    sourceCount = options.samples == 0 || options.samples >= n ? n : options.samples;
+    if (sourceCount < n) {
+        std::mt19937_64 random(options.seed);
+        for (size_t i = 0; i < sourceCount; i++) {
+            std::uniform_int_distribution<size_t> pick(i, n - 1);
+            std::swap(sources[i], sources[pick(random)]);
+        }
+        sources.resize(sourceCount);
+    }
+    normalized = options.normalized;
+
+    recorder.phase(QueryStats::SEARCH);
+    for (auto &workspace : workspaces) std::fill(workspace->centrality.begin(), workspace->centrality.end(), 0.0);
+    ThreadPool::global().parallelFor(0, sourceCount, [&](size_t first, size_t last) {
+        Workspace *workspace = borrow();
+        for (size_t i = first; i < last; i++) accumulate(*workspace, sources[i], options.weighted);
+        giveBack(workspace);
+    }, options.parallel);
+
+    recorder.phase(QueryStats::OUTPUT);
+    centrality.assign(n, 0.0);
+    for (const auto &workspace : workspaces)
+        for (size_t v = 0; v < n; v++) centrality[v] += workspace->centrality[v];
+
+    // undirected paths are found from both ends; sampled sums stand for all n sources
+    double scale = sourceCount == 0 ? 0.0 : (double) n / (double) sourceCount;
+    if (!snapshot.isDirected()) scale /= 2.0;
+    if (normalized) scale = n <= 2 ? 0.0 : scale / ((double) (n - 1) * (double) (n - 2) / (snapshot.isDirected() ? 1.0 : 2.0));
+    for (double &value : centrality) value *= scale;
+    return *this;
+}
+
+template<class T, class W, class G>
+double CentralityAlgorithm<T, W, G>::getCentrality(const T &vertex) const {
+    const VertexId v = snapshot.find(vertex);
+    if (v == NO_VERTEX || v >= centrality.size()) return 0.0;
+    return centrality[v];
+}
+
+template<class T, class W, class G>
+std::vector<std::pair<T, double>> CentralityAlgorithm<T, W, G>::getTop(size_t count) const {
+    std::vector<VertexId> candidates(centrality.size());
+    for (VertexId v = 0; v < candidates.size(); v++) candidates[v] = v;
+
+    auto higher = [&](VertexId a, VertexId b) {
+        return centrality[a] != centrality[b] ? centrality[a] > centrality[b] : a < b;
+    };
+    count = std::min(count, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), higher);
+
+    std::vector<std::pair<T, double>> top;
+    top.reserve(count);
+    for (size_t i = 0; i < count; i++) top.emplace_back(snapshot.getVertex(candidates[i]), centrality[candidates[i]]);
+    return top;
+}
+
+template<class T, class W, class G>
+size_t CentralityAlgorithm<T, W, G>::getSourceCount() const {
+    return sourceCount;
+}
+
+template<class T, class W, class G>
+double CentralityAlgorithm<T, W, G>::getErrorBound(double confidence) const {
+    if (!(confidence > 0.0 && confidence < 1.0))
+        throw std::invalid_argument("CentralityAlgorithm: confidence out of (0, 1)");
+    const size_t n = centrality.size();
+    if (sourceCount == 0 || sourceCount >= n || n <= 2) return 0.0;
+
+    // every per-source dependency is in [0, n - 2]: Hoeffding on their mean, union over the n vertices
+    double bound = (double) n / (double) (n - 1)
+                   * std::sqrt(std::log(2.0 * (double) n / (1.0 - confidence)) / (2.0 * (double) sourceCount));
+    if (!normalized) bound *= (double) (n - 1) * (double) (n - 2) / (snapshot.isDirected() ? 1.0 : 2.0);
+    return bound;
+}
+
+template<class T, class W, class G>
+size_t CentralityAlgorithm<T, W, G>::samplesFor(size_t vertexCount, double epsilon, double confidence) {
+    if (!(epsilon > 0.0)) throw std::invalid_argument("CentralityAlgorithm: epsilon must be positive");
+    if (!(confidence > 0.0 && confidence < 1.0))
+        throw std::invalid_argument("CentralityAlgorithm: confidence out of (0, 1)");
+    if (vertexCount <= 2) return vertexCount;
+
+    const double n = (double) vertexCount;
+    const double relative = epsilon * (n - 1.0) / n;
+    const double k = std::log(2.0 * n / (1.0 - confidence)) / (2.0 * relative * relative);
+    return (size_t) std::min(n, std::ceil(k));
+}
+
+template<class T, class W, class G>
+const QueryStats &CentralityAlgorithm<T, W, G>::getStats() const {
+    return recorder.getStats();
+}
+
+template<class T, class W, class G>
+MemoryUsage CentralityAlgorithm<T, W, G>::memoryUsage() const {
+    MemoryUsage usage = snapshot.memoryUsage();
+    usage += MemoryUsage::of(centrality);
+    for (const auto &workspace : workspaces) {
+        usage += MemoryUsage::of(workspace->distTo);
+        usage += MemoryUsage::of(workspace->paths);
+        usage += MemoryUsage::of(workspace->dependency);
+        usage += MemoryUsage::of(workspace->settled);
+        usage += MemoryUsage::of(workspace->marked);
+        usage += workspace->heap.memoryUsage();
+        usage += MemoryUsage::of(workspace->centrality);
+    }
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_CENTRALITYALGORITHM_HPP
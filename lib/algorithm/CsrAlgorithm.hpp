@@ -0,0 +1,249 @@
+#ifndef GRAPHALGORITHM_CSRALGORITHM_HPP
+#define GRAPHALGORITHM_CSRALGORITHM_HPP
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "CsrGraph.hpp"
+#include "Instrumentation.hpp"
+#include "PairHeap.hpp"
+#include "RadixHeap.hpp"
+#include "WeightTraits.hpp"
+
+/**
+ * Graph algorithms over a CsrGraph, with state kept in flat arrays indexed by vertex id.
+ *
+ * Weighted searches take the edge lengths as a column indexed by edge id (the CSR weights,
+ * or any column of an EdgeColumns), so the kernel only streams the attribute it needs.
+ * With unsigned integer weights the search runs on a RadixHeap instead of a binary heap.
+ *
+ * @tparam W weight type stored in the CsrGraph
+ */
+template<class W = double>
+class CsrAlgorithm {
+public:
+    using VertexId = typename CsrGraph<W>::VertexId;
+    using EdgeId = typename CsrGraph<W>::EdgeId;
+    using Distance = typename WeightTraits<W>::Distance;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+    /**
+     * Returned by pathLength for a vertex the last search did not reach.
+     */
+    static constexpr size_t NO_PATH = std::numeric_limits<size_t>::max();
+
+private:
+    const CsrGraph<W> *graph;
+    using Queue = std::conditional_t<std::is_unsigned_v<Distance>, RadixHeap<VertexId>, PairHeap<VertexId, Distance>>;
+
+    std::vector<Distance> distTo;
+    std::vector<VertexId> parent;
+    std::vector<bool> marked;
+    Queue minHeap;
+    Instrumentation recorder;
+    std::vector<VertexId> pathBuffer;
+
+    void clearDataStructure();
+
+public:
+    explicit CsrAlgorithm(const CsrGraph<W> *graph);
+    void changeGraph(const CsrGraph<W> *graf);
+
+    /**
+     * @brief Single source shortest paths using the weights stored in the graph.
+     */
+    CsrAlgorithm<W> &dijkstra(VertexId source);
+
+    /**
+     * @brief Single source shortest paths using an external length column.
+     *
+     * @param source The source vertex.
+     * @param weights Anything indexable by edge id with getEdgeCount() entries,
+     *                e.g. columns.column<TRAVEL_TIME>().
+     */
+    template<class Column>
+    CsrAlgorithm<W> &dijkstra(VertexId source, const Column &weights);
+
+    /**
+     * @return True if the last search settled the vertex.
+     */
+    bool hasPathTo(VertexId seek) const;
+
+    /**
+     * @return The distance found by the last search, WeightTraits<W>::infinity() if unreachable.
+     */
+    Distance sourceDistTo(VertexId seek) const;
+
+    /**
+     * @return The vertices of the path from the source to the vertex, in forward order; empty if unreachable.
+     */
+    std::vector<VertexId> pathTo(VertexId to) const;
+
+    /**
+     * @brief Writes the path from the source to the vertex, source first, through an internal
+     * buffer that is reused: nothing is allocated once it has grown to the longest path.
+     *
+     * @return The iterator past the last vertex written; nothing is written if to is unreachable.
+     */
+    template<class OutputIt>
+    OutputIt pathTo(VertexId to, OutputIt out);
+
+    /**
+     * @brief Replaces the content of path by the vertices from the source to the vertex, source
+     * first, filled in place from the back. The capacity of path is kept.
+     *
+     * @return False, with path empty, if to is unreachable.
+     */
+    bool pathInto(VertexId to, std::vector<VertexId> &path) const;
+
+    /**
+     * @return The number of edges on the path from the source to the vertex, 0 for the source,
+     *         NO_PATH if unreachable.
+     */
+    size_t pathLength(VertexId to) const;
+
+    /**
+     * @return What the last search did, see GraphAlgorithm::getStats. There is no hash lookup here.
+     */
+    const QueryStats &getStats() const;
+
+    /**
+     * @return The bytes of the per-vertex arrays and the heap kept between searches.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class W>
+CsrAlgorithm<W>::CsrAlgorithm(const CsrGraph<W> *graph) : graph(graph) {
+    if constexpr (!std::is_unsigned_v<Distance>)
+        PairHeap<VertexId, Distance>::minPairHeap(minHeap);
+}
+
+template<class W>
+void CsrAlgorithm<W>::changeGraph(const CsrGraph<W> *graf) {
+    this->graph = graf;
+}
+
+template<class W>
+void CsrAlgorithm<W>::clearDataStructure() {
+    const size_t n = graph->getVertexCount();
+    distTo.assign(n, WeightTraits<W>::infinity());
+    parent.assign(n, NO_VERTEX);
+    marked.assign(n, false);
+    minHeap.clear();
+}
+
+template<class W>
+CsrAlgorithm<W> &CsrAlgorithm<W>::dijkstra(VertexId source) {
+    return dijkstra(source, graph->getWeights());
+}
+
+template<class W>
+template<class Column>
+CsrAlgorithm<W> &CsrAlgorithm<W>::dijkstra(VertexId source, const Column &weights) {
+    auto query = recorder.scope();
+    clearDataStructure();
+    if (source >= graph->getVertexCount()) return *this;
+
+    const auto &offsets = graph->getOffsets();
+    const auto &targets = graph->getTargets();
+
+    distTo[source] = 0;
+    minHeap.add(source, 0);
+    recorder.pushed(minHeap.size());
+    recorder.phase(QueryStats::SEARCH);
+
+    while (!minHeap.isEmpty()) {
+        VertexId current = minHeap.pool();
+        recorder.popped();
+        if (marked[current]) {
+            recorder.stale();
+            continue;
+        }
+        marked[current] = true;
+        recorder.settled();
+
+        const Distance base = distTo[current];
+        for (EdgeId e = offsets[current]; e < offsets[current + 1]; e++) {
+            recorder.scanned();
+            const VertexId to = targets[e];
+            const Distance candidate = base + static_cast<Distance>(weights[e]);
+            if (candidate < distTo[to]) {
+                distTo[to] = candidate;
+                parent[to] = current;
+                minHeap.add(to, candidate);
+                recorder.pushed(minHeap.size());
+            }
+        }
+    }
+
+    return *this;
+}
+
+template<class W>
+const QueryStats &CsrAlgorithm<W>::getStats() const {
+    return recorder.getStats();
+}
+
+template<class W>
+MemoryUsage CsrAlgorithm<W>::memoryUsage() const {
+    MemoryUsage usage = MemoryUsage::of(distTo);
+    usage += MemoryUsage::of(parent);
+    usage += MemoryUsage::of(marked);
+    usage += minHeap.memoryUsage();
+    usage += MemoryUsage::of(pathBuffer);
+    return usage;
+}
+
+template<class W>
+bool CsrAlgorithm<W>::hasPathTo(VertexId seek) const {
+    return seek < marked.size() && marked[seek];
+}
+
+template<class W>
+typename CsrAlgorithm<W>::Distance CsrAlgorithm<W>::sourceDistTo(VertexId seek) const {
+    return seek < distTo.size() ? distTo[seek] : WeightTraits<W>::infinity();
+}
+
+template<class W>
+std::vector<typename CsrAlgorithm<W>::VertexId> CsrAlgorithm<W>::pathTo(VertexId to) const {
+    std::vector<VertexId> path;
+    pathInto(to, path);
+    return path;
+}
+
+template<class W>
+template<class OutputIt>
+OutputIt CsrAlgorithm<W>::pathTo(VertexId to, OutputIt out) {
+    if (!pathInto(to, pathBuffer)) return out;
+    return std::copy(pathBuffer.begin(), pathBuffer.end(), out);
+}
+
+template<class W>
+bool CsrAlgorithm<W>::pathInto(VertexId to, std::vector<VertexId> &path) const {
+    const size_t hops = pathLength(to);
+    if (hops == NO_PATH) {
+        path.clear();
+        return false;
+    }
+
+    // parents are plain array reads, so walking twice beats reversing
+    path.resize(hops + 1);
+    size_t i = hops + 1;
+    for (VertexId seek = to; seek != NO_VERTEX; seek = parent[seek]) path[--i] = seek;
+    return true;
+}
+
+template<class W>
+size_t CsrAlgorithm<W>::pathLength(VertexId to) const {
+    if (!hasPathTo(to)) return NO_PATH;
+
+    size_t hops = 0;
+    for (VertexId seek = parent[to]; seek != NO_VERTEX; seek = parent[seek]) hops++;
+    return hops;
+}
+
+#endif //GRAPHALGORITHM_CSRALGORITHM_HPP
@@ -0,0 +1,474 @@
+#ifndef GRAPHALGORITHM_DAGALGORITHM_HPP
+#define GRAPHALGORITHM_DAGALGORITHM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "DenseSnapshot.hpp"
+#include "Digraph.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryUsage.hpp"
+#include "ThreadPool.hpp"
+#include "WeightTraits.hpp"
+
+/**
+ * Topological order and linear-time paths of a directed acyclic graph.
+ *
+ * Kahn's algorithm peels the graph level by level (level 0 holds the vertices without in-edges,
+ * level k those whose longest chain of predecessors has k edges). Shortest and longest paths relax
+ * the edges once in that order, without any heap: O(V + E) where dijkstra is O(E log V), and
+ * longest (critical) paths, which dijkstra cannot compute at all, cost the same.
+ *
+ * Unlike the other DenseSnapshot users, both sorts take a new snapshot, so sorting again is
+ * enough after editing the graph; path queries reuse the last one.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges
+ * @tparam G graph type, a Digraph (an undirected Graph always has cycles)
+ */
+template<class T, class W = double, class G = Digraph<T, W>>
+class DagAlgorithm {
+public:
+    using Distance = typename WeightTraits<W>::Distance;
+    using VertexId = typename DenseSnapshot<T, W, G>::VertexId;
+    using EdgeId = typename DenseSnapshot<T, W, G>::EdgeId;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+private:
+    DenseSnapshot<T, W, G> snapshot;
+    bool sorted = false;
+
+    std::vector<VertexId> order;
+    std::vector<size_t> levelStart;
+    std::vector<T> sortedVertices;
+    std::vector<T> cycle;
+
+    std::vector<Distance> distTo;
+    std::vector<VertexId> parent;
+    std::vector<bool> reached;
+    VertexId criticalEnd = NO_VERTEX;
+    Instrumentation recorder;
+
+    /**
+     * @brief Turns the order into vertices, or looks for a cycle among the vertices left out of it.
+     */
+    void finishSort();
+    void findCycle();
+
+    /**
+     * @brief Sorts if needed.
+     * @throw std::logic_error If the graph has a cycle.
+     */
+    void requireOrder();
+
+    /**
+     * @brief Starts a path query: every vertex unreached.
+     */
+    void clearDataStructure();
+
+    /**
+     * @brief Relaxes every edge leaving a reached vertex, in topological order, keeping the
+     * distance for which better(new, old) holds.
+     */
+    template<class Better>
+    void relax(Better better);
+
+public:
+    explicit DagAlgorithm(G *graph);
+    void changeGraph(G *graf);
+
+    /**
+     * @brief Kahn's algorithm: repeatedly removes the vertices left without in-edges.
+     *
+     * Inside a level, vertices are sorted by their first appearance in the graph, which costs
+     * O(V log V) on top of the O(V + E) peeling but makes the order the same as parallelTopologicalSort.
+     *
+     * If the graph has a cycle, the vertices on and after cycles are never removed: isAcyclic()
+     * is then false, getOrder() holds only the removed ones and getCycle() one cycle.
+     */
+    DagAlgorithm<T, W, G> &topologicalSort();
+
+    /**
+     * @brief Same as topologicalSort, with each level processed in parallel on ThreadPool::global():
+     * the in-degrees are atomic counters and a vertex joins the next level when its counter drops to 0.
+     *
+     * Returns exactly the order of topologicalSort, whatever the thread count. Levels smaller than
+     * the grain (1024 by default) run on the calling thread only.
+     */
+    DagAlgorithm<T, W, G> &parallelTopologicalSort(const ParallelOptions &options = ParallelOptions());
+
+    /**
+     * @return False if the last sort found a cycle.
+     */
+    bool isAcyclic() const;
+
+    /**
+     * @return The vertices in topological order, level after level.
+     */
+    const std::vector<T> &getOrder() const;
+
+    /**
+     * @return The number of levels, i.e. the vertex count of the longest chain.
+     */
+    size_t getLevelCount() const;
+
+    /**
+     * @return The vertices of a level, all of them independent of each other.
+     */
+    std::vector<T> getLevel(size_t level) const;
+
+    /**
+     * @return The vertices of one cycle, each with an edge to the next and the last to the first;
+     *         empty if the graph is acyclic.
+     */
+    const std::vector<T> &getCycle() const;
+
+    /**
+     * @brief Single source shortest paths, negative weights allowed.
+     * @throw std::logic_error If the graph has a cycle.
+     */
+    DagAlgorithm<T, W, G> &shortestPaths(const T &source);
+
+    /**
+     * @brief Single source longest paths.
+     * @throw std::logic_error If the graph has a cycle.
+     */
+    DagAlgorithm<T, W, G> &longestPaths(const T &source);
+
+    /**
+     * @brief Longest paths from any vertex: sourceDistTo(v) is then the length of the longest path
+     * ending at v (its earliest start time, for durations on the edges) and getCriticalPath() the
+     * longest path of the graph.
+     * @throw std::logic_error If the graph has a cycle.
+     */
+    DagAlgorithm<T, W, G> &criticalPath();
+
+    /**
+     * @return The longest path found by the last criticalPath, from its first to its last vertex.
+     */
+    std::vector<T> getCriticalPath() const;
+
+    bool hasPathTo(const T &seek) const;
+
+    /**
+     * @return The distance computed by the last path query, WeightTraits<W>::infinity() if unreached.
+     */
+    Distance sourceDistTo(const T &seek) const;
+
+    /**
+     * @return The path of the last query from its source to the vertex, empty if unreached.
+     */
+    std::vector<T> pathTo(const T &to) const;
+
+    /**
+     * @return Counters and phase timings of the last path query; all zero unless built with
+     *         GRAPHALGORITHM_INSTRUMENTATION.
+     */
+    const QueryStats &getStats() const;
+
+    /**
+     * @return The bytes of the snapshot and of the query state.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class T, class W, class G>
+DagAlgorithm<T, W, G>::DagAlgorithm(G *graph) : snapshot(graph) {}
+
+template<class T, class W, class G>
+void DagAlgorithm<T, W, G>::changeGraph(G *graf) {
+    snapshot.changeGraph(graf);
+    sorted = false;
+}
+
+template<class T, class W, class G>
+DagAlgorithm<T, W, G> &DagAlgorithm<T, W, G>::topologicalSort() {
+    snapshot.build();
+    const auto &csr = snapshot.getCsr();
+    const size_t n = snapshot.size();
+
+    std::vector<VertexId> inDegree(n, 0);
+    for (VertexId target : csr.getTargets()) inDegree[target]++;
+
+    order.clear();
+    order.reserve(n);
+    levelStart.assign(1, 0);
+    for (VertexId v = 0; v < n; v++)
+        if (inDegree[v] == 0) order.push_back(v);
+
+    // order doubles as the queue: a level ends where the previous one stopped appending
+    for (size_t begin = 0; begin < order.size();) {
+        const size_t end = order.size();
+        levelStart.push_back(end);
+        for (size_t i = begin; i < end; i++) {
+            const VertexId u = order[i];
+            for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++)
+                if (--inDegree[csr.getTarget(e)] == 0) order.push_back(csr.getTarget(e));
+        }
+        std::sort(order.begin() + end, order.end());
+        begin = end;
+    }
+
+    finishSort();
+    return *this;
+}
+
+template<class T, class W, class G>
+DagAlgorithm<T, W, G> &DagAlgorithm<T, W, G>::parallelTopologicalSort(const ParallelOptions &options) {
+    snapshot.build();
+    const auto &csr = snapshot.getCsr();
+    const size_t n = snapshot.size();
+    ThreadPool &pool = ThreadPool::global();
+
+    ParallelOptions perLevel = options;
+    if (perLevel.grain == 0) perLevel.grain = 1024;
+
+    std::unique_ptr<std::atomic<VertexId>[]> inDegree(new std::atomic<VertexId>[n]);
+    pool.parallelFor(0, n, [&](size_t first, size_t last) {
+        for (size_t v = first; v < last; v++) inDegree[v].store(0, std::memory_order_relaxed);
+    }, options);
+    pool.parallelFor(0, n, [&](size_t first, size_t last) {
+        for (EdgeId e = csr.edgeBegin(first); e < csr.edgeBegin(last); e++)
+            inDegree[csr.getTarget(e)].fetch_add(1, std::memory_order_relaxed);
+    }, options);
+
+    order.clear();
+    order.reserve(n);
+    levelStart.assign(1, 0);
+    for (VertexId v = 0; v < n; v++)
+        if (inDegree[v].load(std::memory_order_relaxed) == 0) order.push_back(v);
+
+    std::mutex appending;
+    for (size_t begin = 0; begin < order.size();) {
+        const size_t end = order.size();
+        levelStart.push_back(end);
+
+        // the last decrement of a counter sees every other one (acq_rel), so exactly one thread adds the vertex
+        pool.parallelFor(begin, end, [&](size_t first, size_t last) {
+            std::vector<VertexId> ready;
+            for (size_t i = first; i < last; i++) {
+                const VertexId u = order[i];
+                for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++)
+                    if (inDegree[csr.getTarget(e)].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        ready.push_back(csr.getTarget(e));
+            }
+            if (ready.empty()) return;
+            std::lock_guard<std::mutex> guard(appending);
+            order.insert(order.end(), ready.begin(), ready.end());
+        }, perLevel);
+
+        std::sort(order.begin() + end, order.end());
+        begin = end;
+    }
+
+    finishSort();
+    return *this;
+}
+
+template<class T, class W, class G>
+void DagAlgorithm<T, W, G>::finishSort() {
+    sortedVertices.clear();
+    sortedVertices.reserve(order.size());
+    for (VertexId v : order) sortedVertices.push_back(snapshot.getVertex(v));
+
+    cycle.clear();
+    if (order.size() < snapshot.size()) findCycle();
+    sorted = true;
+}
+
+template<class T, class W, class G>
+void DagAlgorithm<T, W, G>::findCycle() {
+    // iterative DFS over the vertices Kahn could not remove: all of them have a predecessor among
+    // themselves, so they contain a cycle and some DFS meets a back edge to a vertex on its stack
+    enum Color : uint8_t { WHITE, GREY, BLACK };
+    const auto &csr = snapshot.getCsr();
+    std::vector<uint8_t> color(snapshot.size(), WHITE);
+    for (VertexId v : order) color[v] = BLACK;
+
+    std::vector<std::pair<VertexId, EdgeId>> stack;
+    for (VertexId root = 0; root < snapshot.size(); root++) {
+        if (color[root] != WHITE) continue;
+        color[root] = GREY;
+        stack.emplace_back(root, csr.edgeBegin(root));
+
+        while (!stack.empty()) {
+            auto &[u, next] = stack.back();
+            if (next == csr.edgeEnd(u)) {
+                color[u] = BLACK;
+                stack.pop_back();
+                continue;
+            }
+
+            const VertexId v = csr.getTarget(next++);
+            if (color[v] == WHITE) {
+                color[v] = GREY;
+                stack.emplace_back(v, csr.edgeBegin(v));
+            } else if (color[v] == GREY) {
+                size_t start = stack.size() - 1;
+                while (stack[start].first != v) start--;
+                for (size_t i = start; i < stack.size(); i++) cycle.push_back(snapshot.getVertex(stack[i].first));
+                return;
+            }
+        }
+    }
+}
+
+template<class T, class W, class G>
+void DagAlgorithm<T, W, G>::requireOrder() {
+    if (!sorted) topologicalSort();
+    if (!isAcyclic()) throw std::logic_error("DagAlgorithm: the graph has a cycle");
+}
+
+template<class T, class W, class G>
+bool DagAlgorithm<T, W, G>::isAcyclic() const {
+    return cycle.empty();
+}
+
+template<class T, class W, class G>
+const std::vector<T> &DagAlgorithm<T, W, G>::getOrder() const {
+    return sortedVertices;
+}
+
+template<class T, class W, class G>
+size_t DagAlgorithm<T, W, G>::getLevelCount() const {
+    return levelStart.size() - 1;
+}
+
+template<class T, class W, class G>
+std::vector<T> DagAlgorithm<T, W, G>::getLevel(size_t level) const {
+    if (level + 1 >= levelStart.size()) return {};
+    return std::vector<T>(sortedVertices.begin() + levelStart[level], sortedVertices.begin() + levelStart[level + 1]);
+}
+
+template<class T, class W, class G>
+const std::vector<T> &DagAlgorithm<T, W, G>::getCycle() const {
+    return cycle;
+}
+
+template<class T, class W, class G>
+void DagAlgorithm<T, W, G>::clearDataStructure() {
+    const size_t n = snapshot.size();
+    distTo.assign(n, WeightTraits<W>::infinity());
+    parent.assign(n, NO_VERTEX);
+    reached.assign(n, false);
+    criticalEnd = NO_VERTEX;
+}
+
+template<class T, class W, class G>
+template<class Better>
+void DagAlgorithm<T, W, G>::relax(Better better) {
+    const auto &csr = snapshot.getCsr();
+    recorder.phase(QueryStats::SEARCH);
+    for (VertexId u : order) {
+        if (!reached[u]) continue;
+        recorder.settled();
+        for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+            recorder.scanned();
+            const VertexId v = csr.getTarget(e);
+            const Distance distance = distTo[u] + csr.getWeight(e);
+            if (reached[v] && !better(distance, distTo[v])) continue;
+            distTo[v] = distance;
+            parent[v] = u;
+            reached[v] = true;
+        }
+    }
+    recorder.phase(QueryStats::OUTPUT);
+}
+
+template<class T, class W, class G>
+DagAlgorithm<T, W, G> &DagAlgorithm<T, W, G>::shortestPaths(const T &source) {
+    auto query = recorder.scope();
+    requireOrder();
+    clearDataStructure();
+    const VertexId s = snapshot.find(source);
+    if (s == NO_VERTEX) return *this;
+
+    distTo[s] = 0;
+    reached[s] = true;
+    relax([](Distance candidate, Distance current) { return candidate < current; });
+    return *this;
+}
+
+template<class T, class W, class G>
+DagAlgorithm<T, W, G> &DagAlgorithm<T, W, G>::longestPaths(const T &source) {
+    auto query = recorder.scope();
+    requireOrder();
+    clearDataStructure();
+    const VertexId s = snapshot.find(source);
+    if (s == NO_VERTEX) return *this;
+
+    distTo[s] = 0;
+    reached[s] = true;
+    relax([](Distance candidate, Distance current) { return candidate > current; });
+    return *this;
+}
+
+template<class T, class W, class G>
+DagAlgorithm<T, W, G> &DagAlgorithm<T, W, G>::criticalPath() {
+    auto query = recorder.scope();
+    requireOrder();
+    clearDataStructure();
+    std::fill(distTo.begin(), distTo.end(), 0);
+    reached.assign(snapshot.size(), true);
+    relax([](Distance candidate, Distance current) { return candidate > current; });
+
+    for (VertexId v = 0; v < snapshot.size(); v++)
+        if (criticalEnd == NO_VERTEX || distTo[v] > distTo[criticalEnd]) criticalEnd = v;
+    return *this;
+}
+
+template<class T, class W, class G>
+std::vector<T> DagAlgorithm<T, W, G>::getCriticalPath() const {
+    if (criticalEnd == NO_VERTEX) return {};
+    return pathTo(snapshot.getVertex(criticalEnd));
+}
+
+template<class T, class W, class G>
+bool DagAlgorithm<T, W, G>::hasPathTo(const T &seek) const {
+    const VertexId v = snapshot.find(seek);
+    return v != NO_VERTEX && v < reached.size() && reached[v];
+}
+
+template<class T, class W, class G>
+typename DagAlgorithm<T, W, G>::Distance DagAlgorithm<T, W, G>::sourceDistTo(const T &seek) const {
+    const VertexId v = snapshot.find(seek);
+    if (v == NO_VERTEX || v >= reached.size() || !reached[v]) return WeightTraits<W>::infinity();
+    return distTo[v];
+}
+
+template<class T, class W, class G>
+std::vector<T> DagAlgorithm<T, W, G>::pathTo(const T &to) const {
+    std::vector<T> path;
+    if (!hasPathTo(to)) return path;
+    for (VertexId v = snapshot.find(to); v != NO_VERTEX; v = parent[v]) path.push_back(snapshot.getVertex(v));
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+template<class T, class W, class G>
+const QueryStats &DagAlgorithm<T, W, G>::getStats() const {
+    return recorder.getStats();
+}
+
+template<class T, class W, class G>
+MemoryUsage DagAlgorithm<T, W, G>::memoryUsage() const {
+    MemoryUsage usage = snapshot.memoryUsage();
+    usage += MemoryUsage::of(order);
+    usage += MemoryUsage::of(levelStart);
+    usage += MemoryUsage::of(sortedVertices);
+    usage += MemoryUsage::of(cycle);
+    usage += MemoryUsage::of(distTo);
+    usage += MemoryUsage::of(parent);
+    usage += MemoryUsage::of(reached);
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_DAGALGORITHM_HPP
@@ -0,0 +1,547 @@
+#ifndef GRAPHALGORITHM_FLOWALGORITHM_HPP
+#define GRAPHALGORITHM_FLOWALGORITHM_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "DenseSnapshot.hpp"
+#include "Digraph.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryUsage.hpp"
+#include "ResidualGraph.hpp"
+#include "WeightTraits.hpp"
+
+/**
+ * Maximum flow and minimum cut between two vertices of a Digraph, edge weights being capacities.
+ *
+ * The ResidualGraph is packed from the DenseSnapshot once and only reset between queries, which
+ * all start again from zero flow. Two engines compute the same flow value:
+ *  - dinic: BFS levels, then blocking flows along level-increasing arcs with a current-arc
+ *    pointer per vertex, O(V^2 E) and much faster on unit capacities and shallow graphs;
+ *  - pushRelabel: highest-label push-relabel with the gap and global relabeling heuristics,
+ *    O(V^2 sqrt(E)) and usually the fastest on large, deep or dense networks.
+ *
+ * After a query, getFlows() gives the flow of every edge and getSourceSide() / getCutEdges() a
+ * minimum cut: the vertices still reachable from the source in the residual network.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges, read as capacities (must not be negative)
+ * @tparam G graph type, a Digraph
+ */
+template<class T, class W = double, class G = Digraph<T, W>>
+class FlowAlgorithm {
+public:
+    /**
+     * Type of flows and capacities: 64-bit integers for integer weights, double otherwise.
+     */
+    using Flow = typename WeightTraits<W>::Distance;
+    using Residual = ResidualGraph<Flow>;
+    using VertexId = typename Residual::VertexId;
+    using ArcId = typename Residual::ArcId;
+    using EdgeId = typename DenseSnapshot<T, W, G>::EdgeId;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+    /**
+     * An edge of the graph with the flow it carries.
+     */
+    struct FlowEdge {
+        T from;
+        T to;
+        Flow capacity;
+        Flow flow;
+    };
+
+private:
+    DenseSnapshot<T, W, G> snapshot;
+    Residual residual;
+
+    VertexId source = NO_VERTEX;
+    VertexId sink = NO_VERTEX;
+    Flow flowValue = 0;
+
+    // dinic: BFS level and current arc; push-relabel: height and current arc
+    std::vector<VertexId> label;
+    std::vector<ArcId> current;
+    std::vector<VertexId> queue;
+    std::vector<ArcId> path;
+
+    // push-relabel: excess, active vertices by height, all vertices by height (for the gap heuristic)
+    std::vector<Flow> excess;
+    std::vector<VertexId> activeHead;
+    std::vector<VertexId> activeNext;
+    std::vector<VertexId> bucketHead;
+    std::vector<VertexId> bucketNext;
+    std::vector<VertexId> bucketPrev;
+    size_t maxActive = 0;
+    size_t maxBucket = 0;
+
+    std::vector<bool> sourceSide;
+    Instrumentation recorder;
+
+    /**
+     * @brief Builds the residual graph if needed, zeroes the flow and resolves the terminals.
+     * @return False if a terminal is not in the graph.
+     */
+    bool prepare(const T &from, const T &to);
+
+    /**
+     * @brief Marks the vertices reachable from the source through arcs with residual capacity.
+     */
+    void findSourceSide();
+
+    bool levelGraph();
+    Flow blockingFlow();
+
+    /**
+     * @brief Runs highest-label push-relabel until no vertex below height n has excess, with
+     * heights measured towards target; blocked is the other terminal, never relabeled.
+     */
+    void pushRelabelPhase(VertexId target, VertexId blocked);
+    void globalRelabel(VertexId target, VertexId blocked);
+    void activate(VertexId v);
+    void insertBucket(VertexId v);
+    void removeBucket(VertexId v);
+
+    /**
+     * @brief Pushes the excess of v along admissible arcs, relabeling it when none is left.
+     * @return The work done by relabels, in arcs scanned.
+     */
+    size_t discharge(VertexId v, VertexId target, VertexId blocked);
+
+public:
+    explicit FlowAlgorithm(G *graph);
+    void changeGraph(G *graf);
+
+    /**
+     * @brief Maximum flow from source to sink with Dinic's algorithm.
+     * @throw std::invalid_argument If source and sink are the same vertex.
+     */
+    FlowAlgorithm<T, W, G> &dinic(const T &from, const T &to);
+
+    /**
+     * @brief Maximum flow from source to sink with highest-label push-relabel.
+     *
+     * A first phase computes a maximum preflow (enough for the value and the cut), a second one
+     * returns the excess stranded on the source side to the source, so the edge flows are a flow.
+     *
+     * @throw std::invalid_argument If source and sink are the same vertex.
+     */
+    FlowAlgorithm<T, W, G> &pushRelabel(const T &from, const T &to);
+
+    /**
+     * @return The value of the last maximum flow, 0 if a terminal was not in the graph.
+     */
+    Flow getFlowValue() const;
+
+    /**
+     * @return Every edge of the graph with its flow.
+     */
+    std::vector<FlowEdge> getFlows() const;
+
+    /**
+     * @return True if the vertex is on the source side of the minimum cut.
+     */
+    bool onSourceSide(const T &vertex) const;
+
+    /**
+     * @return The source side of the minimum cut.
+     */
+    std::vector<T> getSourceSide() const;
+
+    /**
+     * @return The edges from the source side to the sink side, all saturated; their capacities
+     *         add up to the flow value.
+     */
+    std::vector<FlowEdge> getCutEdges() const;
+
+    /**
+     * @return The residual network left by the last query.
+     */
+    const Residual &getResidualGraph() const;
+
+    /**
+     * @return Counters and phase timings of the last query; all zero unless built with
+     *         GRAPHALGORITHM_INSTRUMENTATION.
+     */
+    const QueryStats &getStats() const;
+
+    /**
+     * @return The bytes of the snapshot, the residual graph and the query state.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class T, class W, class G>
+FlowAlgorithm<T, W, G>::FlowAlgorithm(G *graph) : snapshot(graph) {}
+
+template<class T, class W, class G>
+void FlowAlgorithm<T, W, G>::changeGraph(G *graf) {
+    snapshot.changeGraph(graf);
+}
+
+template<class T, class W, class G>
+bool FlowAlgorithm<T, W, G>::prepare(const T &from, const T &to) {
+    if (from == to) throw std::invalid_argument("FlowAlgorithm: source and sink are the same vertex");
+
+    if (snapshot.refresh()) {
+        const auto &csr = snapshot.getCsr();
+        std::vector<typename Residual::Arc> arcs;
+        arcs.reserve(csr.getEdgeCount());
+        for (VertexId u = 0; u < snapshot.size(); u++)
+            for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++)
+                arcs.push_back({u, csr.getTarget(e), Flow(csr.getWeight(e))});
+        residual = Residual::fromArcs(snapshot.size(), arcs);
+    } else {
+        residual.reset();
+    }
+
+    flowValue = 0;
+    sourceSide.assign(snapshot.size(), false);
+    source = snapshot.find(from);
+    sink = snapshot.find(to);
+    return source != NO_VERTEX && sink != NO_VERTEX;
+}
+
+template<class T, class W, class G>
+void FlowAlgorithm<T, W, G>::findSourceSide() {
+    queue.clear();
+    queue.push_back(source);
+    sourceSide[source] = true;
+    for (size_t head = 0; head < queue.size(); head++) {
+        const VertexId u = queue[head];
+        for (ArcId a = residual.arcBegin(u); a < residual.arcEnd(u); a++) {
+            const VertexId w = residual.getHead(a);
+            if (sourceSide[w] || !(residual.getResidual(a) > 0)) continue;
+            sourceSide[w] = true;
+            queue.push_back(w);
+        }
+    }
+}
+
+template<class T, class W, class G>
+FlowAlgorithm<T, W, G> &FlowAlgorithm<T, W, G>::dinic(const T &from, const T &to) {
+    auto query = recorder.scope();
+    if (!prepare(from, to)) return *this;
+
+    recorder.phase(QueryStats::SEARCH);
+    while (levelGraph()) flowValue += blockingFlow();
+
+    recorder.phase(QueryStats::OUTPUT);
+    findSourceSide();
+    return *this;
+}
+
+template<class T, class W, class G>
+bool FlowAlgorithm<T, W, G>::levelGraph() {
+    label.assign(snapshot.size(), NO_VERTEX);
+    queue.clear();
+    queue.push_back(source);
+    label[source] = 0;
+    for (size_t head = 0; head < queue.size() && label[sink] == NO_VERTEX; head++) {
+        const VertexId u = queue[head];
+        recorder.settled();
+        for (ArcId a = residual.arcBegin(u); a < residual.arcEnd(u); a++) {
+            recorder.scanned();
+            const VertexId w = residual.getHead(a);
+            if (label[w] != NO_VERTEX || !(residual.getResidual(a) > 0)) continue;
+            label[w] = label[u] + 1;
+            queue.push_back(w);
+        }
+    }
+    return label[sink] != NO_VERTEX;
+}
+
+template<class T, class W, class G>
+typename FlowAlgorithm<T, W, G>::Flow FlowAlgorithm<T, W, G>::blockingFlow() {
+    current.resize(snapshot.size());
+    for (VertexId v = 0; v < snapshot.size(); v++) current[v] = residual.arcBegin(v);
+
+    // iterative DFS: path holds the arcs from the source to u
+    Flow total = 0;
+    path.clear();
+    VertexId u = source;
+    while (true) {
+        if (u == sink) {
+            Flow bottleneck = residual.getResidual(path[0]);
+            for (ArcId a : path) bottleneck = std::min(bottleneck, residual.getResidual(a));
+            for (ArcId a : path) residual.push(a, bottleneck);
+            total += bottleneck;
+
+            // retreat to the tail of the first saturated arc
+            size_t saturated = 0;
+            while (residual.getResidual(path[saturated]) > 0) saturated++;
+            path.resize(saturated);
+            u = path.empty() ? source : residual.getHead(path.back());
+            continue;
+        }
+
+        ArcId &a = current[u];
+        const ArcId end = residual.arcEnd(u);
+        for (; a < end; a++) {
+            recorder.scanned();
+            const VertexId w = residual.getHead(a);
+            if (label[w] == label[u] + 1 && residual.getResidual(a) > 0) break;
+        }
+
+        if (a < end) {
+            path.push_back(a);
+            u = residual.getHead(a);
+            continue;
+        }
+
+        // dead end: no augmenting path goes through u in this level graph
+        label[u] = NO_VERTEX;
+        if (path.empty()) break;
+        path.pop_back();
+        u = path.empty() ? source : residual.getHead(path.back());
+        current[u]++;
+    }
+    return total;
+}
+
+template<class T, class W, class G>
+FlowAlgorithm<T, W, G> &FlowAlgorithm<T, W, G>::pushRelabel(const T &from, const T &to) {
+    auto query = recorder.scope();
+    if (!prepare(from, to)) return *this;
+
+    const size_t n = snapshot.size();
+    excess.assign(n, 0);
+    label.assign(n, 0);
+    current.resize(n);
+    activeHead.resize(n);
+    activeNext.resize(n);
+    bucketHead.resize(n);
+    bucketNext.resize(n);
+    bucketPrev.resize(n);
+
+    // saturate every arc leaving the source
+    for (ArcId a = residual.arcBegin(source); a < residual.arcEnd(source); a++) {
+        const Flow amount = residual.getResidual(a);
+        if (!(amount > 0)) continue;
+        residual.push(a, amount);
+        excess[residual.getHead(a)] += amount;
+        excess[source] -= amount;
+    }
+
+    recorder.phase(QueryStats::SEARCH);
+    pushRelabelPhase(sink, source);
+    flowValue = excess[sink];
+
+    // what could not reach the sink goes back to the source
+    pushRelabelPhase(source, sink);
+
+    recorder.phase(QueryStats::OUTPUT);
+    findSourceSide();
+    return *this;
+}
+
+template<class T, class W, class G>
+void FlowAlgorithm<T, W, G>::activate(VertexId v) {
+    activeNext[v] = activeHead[label[v]];
+    activeHead[label[v]] = v;
+    maxActive = std::max<size_t>(maxActive, label[v]);
+}
+
+template<class T, class W, class G>
+void FlowAlgorithm<T, W, G>::insertBucket(VertexId v) {
+    const VertexId height = label[v];
+    bucketPrev[v] = NO_VERTEX;
+    bucketNext[v] = bucketHead[height];
+    if (bucketHead[height] != NO_VERTEX) bucketPrev[bucketHead[height]] = v;
+    bucketHead[height] = v;
+    maxBucket = std::max<size_t>(maxBucket, height);
+}
+
+template<class T, class W, class G>
+void FlowAlgorithm<T, W, G>::removeBucket(VertexId v) {
+    if (bucketPrev[v] != NO_VERTEX) bucketNext[bucketPrev[v]] = bucketNext[v];
+    else bucketHead[label[v]] = bucketNext[v];
+    if (bucketNext[v] != NO_VERTEX) bucketPrev[bucketNext[v]] = bucketPrev[v];
+}
+
+template<class T, class W, class G>
+void FlowAlgorithm<T, W, G>::globalRelabel(VertexId target, VertexId blocked) {
+    const VertexId n = (VertexId) snapshot.size();
+
+    // exact distances to target by a backward BFS over the arcs with residual capacity
+    std::fill(label.begin(), label.end(), n);
+    label[target] = 0;
+    queue.clear();
+    queue.push_back(target);
+    for (size_t head = 0; head < queue.size(); head++) {
+        const VertexId w = queue[head];
+        for (ArcId a = residual.arcBegin(w); a < residual.arcEnd(w); a++) {
+            const VertexId x = residual.getHead(a);
+            if (label[x] != n || x == blocked || x == target) continue;
+            if (!(residual.getResidual(residual.getReverse(a)) > 0)) continue;
+            label[x] = label[w] + 1;
+            queue.push_back(x);
+        }
+    }
+
+    std::fill(activeHead.begin(), activeHead.end(), NO_VERTEX);
+    std::fill(bucketHead.begin(), bucketHead.end(), NO_VERTEX);
+    maxActive = maxBucket = 0;
+    for (VertexId v = 0; v < n; v++) {
+        current[v] = residual.arcBegin(v);
+        if (v == target || v == blocked || label[v] >= n) continue;
+        insertBucket(v);
+        if (excess[v] > 0) activate(v);
+    }
+}
+
+template<class T, class W, class G>
+void FlowAlgorithm<T, W, G>::pushRelabelPhase(VertexId target, VertexId blocked) {
+    const size_t n = snapshot.size();
+    const size_t relabelPeriod = 6 * n + residual.getEdgeCount();
+    size_t work = 0;
+
+    globalRelabel(target, blocked);
+    while (true) {
+        while (maxActive > 0 && activeHead[maxActive] == NO_VERTEX) maxActive--;
+        const VertexId v = activeHead[maxActive];
+        if (v == NO_VERTEX) break;
+        activeHead[maxActive] = activeNext[v];
+
+        recorder.settled();
+        work += discharge(v, target, blocked);
+        if (work > relabelPeriod) {
+            globalRelabel(target, blocked);
+            work = 0;
+        }
+    }
+}
+
+template<class T, class W, class G>
+size_t FlowAlgorithm<T, W, G>::discharge(VertexId v, VertexId target, VertexId blocked) {
+    const VertexId n = (VertexId) snapshot.size();
+    size_t work = 0;
+
+    while (excess[v] > 0) {
+        ArcId &a = current[v];
+        const ArcId end = residual.arcEnd(v);
+        for (; a < end; a++) {
+            recorder.scanned();
+            const VertexId w = residual.getHead(a);
+            if (label[w] + 1 != label[v] || !(residual.getResidual(a) > 0)) continue;
+
+            const Flow amount = std::min(excess[v], residual.getResidual(a));
+            if (w != target && w != blocked && !(excess[w] > 0)) activate(w);
+            residual.push(a, amount);
+            excess[v] -= amount;
+            excess[w] += amount;
+            if (!(excess[v] > 0)) return work;
+        }
+
+        // relabel; if v was the last vertex at its height, everything above is cut off (gap)
+        const VertexId height = label[v];
+        removeBucket(v);
+        if (bucketHead[height] == NO_VERTEX) {
+            for (size_t above = height + 1; above <= maxBucket; above++) {
+                for (VertexId x = bucketHead[above]; x != NO_VERTEX; x = bucketNext[x]) label[x] = n;
+                bucketHead[above] = NO_VERTEX;
+                activeHead[above] = NO_VERTEX;
+            }
+            maxBucket = height > 0 ? height - 1 : 0;
+            maxActive = std::min<size_t>(maxActive, maxBucket);
+            label[v] = n;
+            return work;
+        }
+
+        VertexId lowest = n;
+        ArcId best = residual.arcBegin(v);
+        for (ArcId b = residual.arcBegin(v); b < end; b++) {
+            if (!(residual.getResidual(b) > 0)) continue;
+            const VertexId w = residual.getHead(b);
+            if (label[w] + 1 < lowest) {
+                lowest = label[w] + 1;
+                best = b;
+            }
+        }
+        work += 12 + (end - residual.arcBegin(v));
+
+        label[v] = lowest;
+        if (lowest >= n) return work;
+        current[v] = best;
+        insertBucket(v);
+    }
+    return work;
+}
+
+template<class T, class W, class G>
+typename FlowAlgorithm<T, W, G>::Flow FlowAlgorithm<T, W, G>::getFlowValue() const {
+    return flowValue;
+}
+
+template<class T, class W, class G>
+std::vector<typename FlowAlgorithm<T, W, G>::FlowEdge> FlowAlgorithm<T, W, G>::getFlows() const {
+    std::vector<FlowEdge> flows;
+    flows.reserve(residual.getEdgeCount());
+    for (size_t i = 0; i < residual.getEdgeCount(); i++) {
+        const ArcId a = residual.getEdgeArc(i);
+        flows.push_back({snapshot.getVertex(residual.getHead(residual.getReverse(a))), snapshot.getVertex(residual.getHead(a)),
+                         residual.getCapacity(i), residual.getFlow(i)});
+    }
+    return flows;
+}
+
+template<class T, class W, class G>
+bool FlowAlgorithm<T, W, G>::onSourceSide(const T &vertex) const {
+    const VertexId v = snapshot.find(vertex);
+    return v != NO_VERTEX && v < sourceSide.size() && sourceSide[v];
+}
+
+template<class T, class W, class G>
+std::vector<T> FlowAlgorithm<T, W, G>::getSourceSide() const {
+    std::vector<T> side;
+    for (VertexId v = 0; v < sourceSide.size(); v++)
+        if (sourceSide[v]) side.push_back(snapshot.getVertex(v));
+    return side;
+}
+
+template<class T, class W, class G>
+std::vector<typename FlowAlgorithm<T, W, G>::FlowEdge> FlowAlgorithm<T, W, G>::getCutEdges() const {
+    std::vector<FlowEdge> cut;
+    if (sourceSide.empty()) return cut;
+    for (size_t i = 0; i < residual.getEdgeCount(); i++) {
+        const ArcId a = residual.getEdgeArc(i);
+        const VertexId from = residual.getHead(residual.getReverse(a)), to = residual.getHead(a);
+        if (sourceSide[from] && !sourceSide[to])
+            cut.push_back({snapshot.getVertex(from), snapshot.getVertex(to), residual.getCapacity(i), residual.getFlow(i)});
+    }
+    return cut;
+}
+
+template<class T, class W, class G>
+const typename FlowAlgorithm<T, W, G>::Residual &FlowAlgorithm<T, W, G>::getResidualGraph() const {
+    return residual;
+}
+
+template<class T, class W, class G>
+const QueryStats &FlowAlgorithm<T, W, G>::getStats() const {
+    return recorder.getStats();
+}
+
+template<class T, class W, class G>
+MemoryUsage FlowAlgorithm<T, W, G>::memoryUsage() const {
+    MemoryUsage usage = residual.memoryUsage();
+    usage += snapshot.memoryUsage();
+    usage += MemoryUsage::of(label);
+    usage += MemoryUsage::of(current);
+    usage += MemoryUsage::of(queue);
+    usage += MemoryUsage::of(path);
+    usage += MemoryUsage::of(excess);
+    usage += MemoryUsage::of(activeHead);
+    usage += MemoryUsage::of(activeNext);
+    usage += MemoryUsage::of(bucketHead);
+    usage += MemoryUsage::of(bucketNext);
+    usage += MemoryUsage::of(bucketPrev);
+    usage += MemoryUsage::of(sourceSide);
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_FLOWALGORITHM_HPP
@@ -6,126 +6,496 @@
 #define GRAPHALGORITHM_GRAPHALGORITHM_HPP
 
 #include "Graph.hpp"
+#include <algorithm>
 #include <queue>
 #include <stack>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <numeric>
 #include <limits>
+#include <type_traits>
+#include <vector>
 
+#include "ArenaResource.hpp"
+#include "Instrumentation.hpp"
 #include "PairHeap.hpp"
-
-template <class T>
+#include "TraversalVisitor.hpp"
+#include "WeightTraits.hpp"
+
+/**
+ * Searches over a Graph.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the graph edges; path lengths use WeightTraits<W>::Distance
+ * @tparam G the searched graph: Graph, Digraph, or anything offering the same read side
+ *           (operator[], getVertices, isEmpty), such as VersionedGraph<T, W>::Snapshot
+ *
+ * The scratch state of a search (edgeTo, distTo, marked) is made of std::pmr containers. By
+ * default they live in an ArenaResource owned by the algorithm: a node costs a pointer bump and
+ * starting a new search drops the previous state in O(1) instead of freeing node after node.
+ */
+template <class T, class W = double, class G = Graph<T, W>>
 class GraphAlgorithm {
+public:
+    using Distance = typename WeightTraits<W>::Distance;
+
 private:
 
-    Graph<T> *graph;
-    std::unordered_map<T, Edge<T>> edgeTo;
-    std::unordered_map<T, double> distTo;
-    std::unordered_set<T> marked;
-    PairHeap<T, double> minHeap;
+    using EdgeMap = std::pmr::unordered_map<T, Edge<T, W>>;
+    using DistanceMap = std::pmr::unordered_map<T, Distance>;
+    using MarkSet = std::pmr::unordered_set<T>;
+
+    /**
+     * When depthFirstSearch discovered and finished a vertex.
+     */
+    struct Times {
+        size_t discovery;
+        size_t finish;
+    };
+
+    using TimeMap = std::pmr::unordered_map<T, Times>;
+    using AdjacencyIterator = decltype(std::declval<G &>()[std::declval<const T &>()].begin());
+
+    /**
+     * A vertex of the depth-first path with the next of its edges to examine.
+     */
+    struct Frame {
+        T vertex;
+        AdjacencyIterator next;
+        AdjacencyIterator end;
+    };
+
+    G *graph;
+
+    // declared before the containers: they are destroyed before the blocks holding them
+    ArenaResource arena;
+    std::pmr::memory_resource *scratch;
+
+    EdgeMap edgeTo;
+    DistanceMap distTo;
+    MarkSet marked;
+    TimeMap times;
+    std::vector<T> preorder;
+    std::vector<T> postorder;
+    PairHeap<T, Distance> minHeap;
+    Instrumentation recorder;
+    std::vector<T> pathBuffer;
+
+    // work lists of the visitor traversals, kept to reuse their capacity
+    std::vector<T> frontier;
+    std::vector<Frame> frames;
 
     void clearDataStructure();
-    bool contains(const std::unordered_map<T, Edge<T>> &map, const T &key);
-    bool contains(const std::unordered_set<T> &set,const T &key);
-    void relax(const Edge<T> &edge);
+
+    /**
+     * @brief Replaces a container living in the arena by an empty one, which allocates nothing.
+     * Elements that need no destructor are not visited at all: their memory goes back with the
+     * arena reset.
+     */
+    template<class Container>
+    void abandon(Container &container);
+
+    bool contains(const EdgeMap &map, const T &key);
+    bool contains(const MarkSet &set,const T &key);
+    bool relax(const Edge<T, W> &edge, Distance weight);
+
+    /**
+     * @brief Calls visit on every vertex of the path from to back to the source, with one hash
+     * lookup per hop and no copy. to must have a path.
+     */
+    template<class Visit>
+    void walkBack(const T &to, Visit visit);
 
 public:
-    explicit GraphAlgorithm(Graph<T> *graph);
-    void changeGraph(Graph<T> *graf);
+    /**
+     * Returned by pathLength for a vertex the last search did not reach.
+     */
+    static constexpr size_t NO_PATH = std::numeric_limits<size_t>::max();
+
+    /**
+     * Returned by getDiscoveryTime and getFinishTime for a vertex the last depthFirstSearch did not reach.
+     */
+    static constexpr size_t NO_TIME = std::numeric_limits<size_t>::max();
+
+    explicit GraphAlgorithm(G *graph);
+
+    /**
+     * @param graph The searched graph.
+     * @param scratch Where the scratch state is allocated instead of the built-in arena, e.g. a
+     *                resource shared by several algorithm objects. Containers are then cleared
+     *                element by element between searches.
+     */
+    GraphAlgorithm(G *graph, std::pmr::memory_resource *scratch);
+    void changeGraph(G *graf);
+
+    /**
+     * @brief Depth-first search from a vertex, recording discovery and finish times and the
+     * preorder and postorder of the reached vertices.
+     *
+     * Iterative, with a stack of edge iterators (see depthFirstVisit): every vertex is pushed
+     * once and the traversal tree in edgeTo is a real depth-first tree.
+     */
+    GraphAlgorithm<T, W, G> & depthFirstSearch(const T &seek);
+
+    /**
+     * @brief Breadth-first search from a vertex. Vertices are marked when queued, so the queue
+     * never holds more than V entries and edgeTo is written once per vertex.
+     */
+    GraphAlgorithm<T, W, G> & breadthFirstSearch(const T &seek);
+    GraphAlgorithm<T, W, G> & dijkstra(const T &init);
+
+    /**
+     * @brief Single source shortest paths where the length of an edge is given by a projection.
+     *
+     * @param init The source vertex.
+     * @param weight Callable taking a const Edge<T, W>& and returning its length, so the same graph
+     *               can be searched by distance, travel time, cost...
+     */
+    template<class Weight>
+    GraphAlgorithm<T, W, G> & dijkstra(const T &init, Weight weight);
+
+    void prim(Graph<T, W> *graf, const T& source);
+
+    /**
+     * @brief Minimum spanning tree where the cost of an edge is given by a projection, see dijkstra(init, weight).
+     */
+    template<class Weight>
+    void prim(Graph<T, W> *graf, const T& source, Weight weight);
+
+    /**
+     * @brief Breadth-first traversal driven by a visitor, which can stop it or prune it at any
+     * vertex or edge (see TraversalVisitor).
+     *
+     * A vertex is marked when discovered, so it is queued once. The reached vertices and the
+     * traversal tree are kept as with breadthFirstSearch: hasPathTo and pathTo work afterwards,
+     * also after an early stop, and give paths with the fewest edges.
+     *
+     * @param seek The source vertex.
+     * @param visitor Any type with the three TraversalVisitor callbacks.
+     * @return False if a callback returned STOP, true if the traversal ran to the end.
+     */
+    template<class Visitor>
+    bool breadthFirstVisit(const T &seek, Visitor &visitor);
+
+    /**
+     * @brief Depth-first traversal driven by a visitor, see breadthFirstVisit.
+     *
+     * Iterative: the current path is a stack of (vertex, next edge) frames, so a vertex is
+     * finished once all its descendants are, as in the recursive formulation, but deep graphs
+     * cannot overflow the call stack.
+     */
+    template<class Visitor>
+    bool depthFirstVisit(const T &seek, Visitor &visitor);
+
+    /**
+     * @brief Breadth-first search that only reaches the vertices at most maxDepth edges away
+     * from the source: those at maxDepth are marked but not expanded.
+     */
+    GraphAlgorithm<T, W, G> & breadthFirstSearch(const T &seek, size_t maxDepth);
+
+    /**
+     * @brief Tells whether to can be reached from from, stopping as soon as it is discovered.
+     * On success pathTo(to) gives a path with the fewest edges.
+     */
+    bool reachable(const T &from, const T &to);
 
-    GraphAlgorithm<T> & depthFirstSearch(const T &seek);
-    GraphAlgorithm<T> & breadthFirstSearch(const T &seek);
-    GraphAlgorithm<T> & dijkstra(const T &init);
-    void prim(Graph<T> *graf, const T& source);
     bool hasPathTo(const T &seek);
     std::unique_ptr<std::stack<T>> pathTo(const T &to);
-    double sourceDistTo(const T& seek);
+
+    /**
+     * @brief Writes the path from the source of the last search to a vertex, source first.
+     *
+     * Goes through an internal buffer that is reused, so once it has grown to the longest path
+     * nothing is allocated.
+     *
+     * @param to The last vertex of the path.
+     * @param out Output iterator receiving the vertices.
+     * @return The iterator past the last vertex written; nothing is written if to is unreachable.
+     */
+    template<class OutputIt>
+    OutputIt pathTo(const T &to, OutputIt out);
+
+    /**
+     * @brief Replaces the content of path by the vertices from the source of the last search to
+     * a vertex, source first. The capacity of path is kept, so reusing one vector across queries
+     * allocates nothing once it is large enough.
+     *
+     * @return False, with path empty, if to is unreachable.
+     */
+    bool pathInto(const T &to, std::vector<T> &path);
+
+    /**
+     * @return The number of edges on the path from the source of the last search to the vertex,
+     *         0 for the source itself, NO_PATH if unreachable.
+     */
+    size_t pathLength(const T &to);
+
+    Distance sourceDistTo(const T& seek);
+
+    /**
+     * @return The time the last depthFirstSearch discovered the vertex, from one clock shared with
+     *         the finish times starting at 0; NO_TIME if it was not reached.
+     */
+    size_t getDiscoveryTime(const T &vertex) const;
+
+    /**
+     * @return The time the last depthFirstSearch finished the vertex, NO_TIME if it was not reached.
+     */
+    size_t getFinishTime(const T &vertex) const;
+
+    /**
+     * @return The vertices reached by the last depthFirstSearch, in discovery order.
+     */
+    const std::vector<T> &getPreorder() const;
+
+    /**
+     * @return The vertices reached by the last depthFirstSearch, in finish order; reversed, a
+     *         topological order when the graph is a DAG.
+     */
+    const std::vector<T> &getPostorder() const;
+
+    /**
+     * @return What the last search did: vertices settled, edges scanned, heap traffic, adjacency
+     *         hash probes and the time of each phase. All zero unless the library is built with
+     *         GRAPHALGORITHM_INSTRUMENTATION.
+     */
+    const QueryStats &getStats() const;
+
+    /**
+     * @return The bytes of the scratch state kept between searches (edgeTo, distTo, marked and
+     *         the heap), which is what a long-lived algorithm object costs on top of the graph.
+     */
+    MemoryUsage memoryUsage() const;
 };
 
-template <class T>
-GraphAlgorithm<T>::GraphAlgorithm(Graph<T> *graph) {
-    this->graph = graph;
-    this->minHeap = PairHeap<T, double>::minPairHeap(minHeap);
+template<class T, class W, class G>
+GraphAlgorithm<T, W, G>::GraphAlgorithm(G *graph) : GraphAlgorithm(graph, nullptr) {}
+
+template<class T, class W, class G>
+GraphAlgorithm<T, W, G>::GraphAlgorithm(G *graph, std::pmr::memory_resource *scratch)
+    : graph(graph), scratch(scratch != nullptr ? scratch : &arena),
+      edgeTo(this->scratch), distTo(this->scratch), marked(this->scratch), times(this->scratch) {
+    PairHeap<T, Distance>::minPairHeap(minHeap);
 }
 
-template<class T>
-void GraphAlgorithm<T>::changeGraph(Graph<T> *graf) {
+template<class T, class W, class G>
+void GraphAlgorithm<T, W, G>::changeGraph(G *graf) {
     this->graph = graf;
 }
 
-template<class T>
-GraphAlgorithm<T> & GraphAlgorithm<T>::depthFirstSearch(const T &seek) {
+template<class T, class W, class G>
+GraphAlgorithm<T, W, G> & GraphAlgorithm<T, W, G>::depthFirstSearch(const T &seek) {
     if ((*this->graph)[seek].empty()) return *this;
 
-    clearDataStructure();
+    // one clock for both events, so discovery < finish and a descendant nests inside its ancestor
+    struct Clock : TraversalVisitor<T, W> {
+        GraphAlgorithm<T, W, G> &algorithm;
+        size_t time = 0;
 
-    std::stack<T> nextGen;
-    nextGen.push(seek);
+        explicit Clock(GraphAlgorithm<T, W, G> &algorithm) : algorithm(algorithm) {}
 
-    while (!nextGen.empty()) {
-        const T current = nextGen.top();
-        nextGen.pop();
-        marked.insert(current);
-
-        for (const auto &edge: (*graph)[current]) {
-            if (!contains(marked, edge.getTo())) {
-                nextGen.push(edge.getTo());
+        VisitAction onDiscover(const T &vertex, size_t) {
+            algorithm.times[vertex].discovery = time++;
+            algorithm.preorder.push_back(vertex);
+            return VisitAction::CONTINUE;
+        }
 
-                edgeTo[edge.getTo()] = edge;
-            }
+        VisitAction onFinish(const T &vertex) {
+            algorithm.times[vertex].finish = time++;
+            algorithm.postorder.push_back(vertex);
+            return VisitAction::CONTINUE;
         }
-    }
+    } clock(*this);
 
+    depthFirstVisit(seek, clock);
     return *this;
 }
 
-template<class T>
-GraphAlgorithm<T> &GraphAlgorithm<T>::breadthFirstSearch(const T &seek) {
+template<class T, class W, class G>
+GraphAlgorithm<T, W, G> &GraphAlgorithm<T, W, G>::breadthFirstSearch(const T &seek) {
     if ((*this->graph)[seek].empty()) return *this;
+
+    TraversalVisitor<T, W> visitor;
+    breadthFirstVisit(seek, visitor);
+    return *this;
+}
+
+template<class T, class W, class G>
+template<class Visitor>
+bool GraphAlgorithm<T, W, G>::breadthFirstVisit(const T &seek, Visitor &visitor) {
+    auto query = recorder.scope();
     clearDataStructure();
+    frontier.clear();
+    recorder.phase(QueryStats::SEARCH);
+
+    marked.insert(seek);
+    recorder.settled();
+    const VisitAction start = visitor.onDiscover(seek, 0);
+    if (start == VisitAction::STOP) return false;
+    if (start == VisitAction::PRUNE) return visitor.onFinish(seek) != VisitAction::STOP;
+    frontier.push_back(seek);
+
+    // the frontier is a FIFO read from head; every vertex before levelEnd is at depth
+    size_t depth = 0;
+    size_t levelEnd = frontier.size();
+    for (size_t head = 0; head < frontier.size(); head++) {
+        if (head == levelEnd) {
+            depth++;
+            levelEnd = frontier.size();
+        }
 
-    std::queue<T> nextGen;
-    nextGen.push(seek);
+        const T current = frontier[head];
+        for (const auto &edge : (*graph)[current]) {
+            recorder.scanned();
+            const VisitAction examine = visitor.onExamineEdge(edge);
+            if (examine == VisitAction::STOP) return false;
+            if (examine == VisitAction::PRUNE || contains(marked, edge.getTo())) continue;
+
+            const T &to = edge.getTo();
+            marked.insert(to);
+            edgeTo[to] = edge;
+            recorder.settled();
+
+            const VisitAction discover = visitor.onDiscover(to, depth + 1);
+            if (discover == VisitAction::STOP) return false;
+            if (discover == VisitAction::PRUNE) {
+                if (visitor.onFinish(to) == VisitAction::STOP) return false;
+                continue;
+            }
+            frontier.push_back(to);
+            recorder.pushed(frontier.size() - head);
+        }
 
-    while (!nextGen.empty()) {
-        const T current = nextGen.front();
-        nextGen.pop();
-        marked.insert(current);
+        if (visitor.onFinish(current) == VisitAction::STOP) return false;
+    }
 
-        for (const auto &edge: (*graph)[current]) {
-            if (!contains(marked, edge.getTo())) {
-                nextGen.push(edge.getTo());
+    return true;
+}
 
-                edgeTo[edge.getTo()] = edge;
-            }
+template<class T, class W, class G>
+template<class Visitor>
+bool GraphAlgorithm<T, W, G>::depthFirstVisit(const T &seek, Visitor &visitor) {
+    auto query = recorder.scope();
+    clearDataStructure();
+    frames.clear();
+    recorder.phase(QueryStats::SEARCH);
+
+    marked.insert(seek);
+    recorder.settled();
+    const VisitAction start = visitor.onDiscover(seek, 0);
+    if (start == VisitAction::STOP) return false;
+    if (start == VisitAction::PRUNE) return visitor.onFinish(seek) != VisitAction::STOP;
+
+    const auto &adjacent = (*graph)[seek];
+    frames.push_back(Frame{seek, adjacent.begin(), adjacent.end()});
+
+    while (!frames.empty()) {
+        Frame &top = frames.back();
+        if (top.next == top.end) {
+            if (visitor.onFinish(top.vertex) == VisitAction::STOP) return false;
+            frames.pop_back();
+            continue;
+        }
+
+        const Edge<T, W> &edge = *top.next;
+        ++top.next;
+        recorder.scanned();
+        const VisitAction examine = visitor.onExamineEdge(edge);
+        if (examine == VisitAction::STOP) return false;
+        if (examine == VisitAction::PRUNE || contains(marked, edge.getTo())) continue;
+
+        const T &to = edge.getTo();
+        marked.insert(to);
+        edgeTo[to] = edge;
+        recorder.settled();
+
+        const VisitAction discover = visitor.onDiscover(to, frames.size());
+        if (discover == VisitAction::STOP) return false;
+        if (discover == VisitAction::PRUNE) {
+            if (visitor.onFinish(to) == VisitAction::STOP) return false;
+            continue;
         }
+
+        // top is not used past this point: push_back may move the frames
+        const auto &next = (*graph)[to];
+        frames.push_back(Frame{to, next.begin(), next.end()});
+        recorder.pushed(frames.size());
     }
 
+    return true;
+}
+
+template<class T, class W, class G>
+GraphAlgorithm<T, W, G> &GraphAlgorithm<T, W, G>::breadthFirstSearch(const T &seek, size_t maxDepth) {
+    struct DepthLimit : TraversalVisitor<T, W> {
+        size_t maxDepth;
+
+        explicit DepthLimit(size_t maxDepth) : maxDepth(maxDepth) {}
+
+        VisitAction onDiscover(const T &, size_t depth) {
+            return depth < maxDepth ? VisitAction::CONTINUE : VisitAction::PRUNE;
+        }
+    } visitor(maxDepth);
+
+    breadthFirstVisit(seek, visitor);
     return *this;
 }
 
-template<class T>
-GraphAlgorithm<T> &GraphAlgorithm<T>::dijkstra(const T &init) {
-    if (!contains(graph->getVertices(), init)) return *this;
+template<class T, class W, class G>
+bool GraphAlgorithm<T, W, G>::reachable(const T &from, const T &to) {
+    struct Target : TraversalVisitor<T, W> {
+        const T &target;
+
+        explicit Target(const T &target) : target(target) {}
+
+        VisitAction onDiscover(const T &vertex, size_t) {
+            return vertex == target ? VisitAction::STOP : VisitAction::CONTINUE;
+        }
+    } visitor(to);
+
+    return !breadthFirstVisit(from, visitor);
+}
+
+template<class T, class W, class G>
+GraphAlgorithm<T, W, G> &GraphAlgorithm<T, W, G>::dijkstra(const T &init) {
+    return dijkstra(init, [](const Edge<T, W> &edge) { return edge.getWeight(); });
+}
+
+template<class T, class W, class G>
+template<class Weight>
+GraphAlgorithm<T, W, G> &GraphAlgorithm<T, W, G>::dijkstra(const T &init, Weight weight) {
+    auto query = recorder.scope();
+    if (!graph->getVertices().contains(init)) return *this;
 
     clearDataStructure();
 
-    const double INFINITY = std::numeric_limits<double>::infinity();
+    const Distance UNREACHABLE = WeightTraits<W>::infinity();
     for (const auto &vertex : graph->getVertices()) {
-        distTo[vertex] = INFINITY;
+        distTo[vertex] = UNREACHABLE;
     }
 
     distTo[init] = 0;
-    marked.insert(init);
     minHeap.add(init, 0);
+    recorder.pushed(minHeap.size());
+    recorder.phase(QueryStats::SEARCH);
 
+    // lazy deletion: a vertex may sit in the heap several times, only its first pop settles it
     while (!minHeap.isEmpty()) {
         T current = minHeap.pool();
+        recorder.popped();
+        if (contains(marked, current)) {
+            recorder.stale();
+            continue;
+        }
+        marked.insert(current);
+        recorder.settled();
+
         for (const auto& edge : (*graph)[current]) {
-            if (!contains(marked, edge.getTo())) {
-                minHeap.add(edge.getTo(), edge.getWeight());
-                marked.insert(edge.getTo());
-                relax(edge);
+            recorder.scanned();
+            if (!contains(marked, edge.getTo()) && relax(edge, weight(edge))) {
+                minHeap.add(edge.getTo(), distTo[edge.getTo()]);
+                recorder.pushed(minHeap.size());
             }
         }
     }
@@ -133,90 +503,221 @@ GraphAlgorithm<T> &GraphAlgorithm<T>::dijkstra(const T &init) {
     return *this;
 }
 
-template<class T>
-void GraphAlgorithm<T>::prim(Graph<T> *graf, const T& source) {
+template<class T, class W, class G>
+void GraphAlgorithm<T, W, G>::prim(Graph<T, W> *graf, const T& source) {
+    prim(graf, source, [](const Edge<T, W> &edge) { return edge.getWeight(); });
+}
+
+template<class T, class W, class G>
+template<class Weight>
+void GraphAlgorithm<T, W, G>::prim(Graph<T, W> *graf, const T& source, Weight weight) {
+    auto query = recorder.scope();
     if (graph->isEmpty() || (*graph)[source].empty()) return;
 
     clearDataStructure();
 
-    const double INFINITY = std::numeric_limits<double>::infinity();
+    const Distance UNREACHABLE = WeightTraits<W>::infinity();
     for (const auto& vertex : graph->getVertices())
-        distTo[vertex] = INFINITY;
+        distTo[vertex] = UNREACHABLE;
 
     distTo[source] = 0;
     minHeap.add(source, 0);
-    int countFormedBranch = 0;
+    recorder.pushed(minHeap.size());
+    recorder.phase(QueryStats::SEARCH);
+    // a tree branch is formed when a vertex other than the source is settled, not on every improvement
+    size_t countFormedBranch = 0;
     while (!minHeap.isEmpty() && countFormedBranch < (graph->getVertices().size() - 1)) {
         T currentData = minHeap.pool();
-        if (contains(marked, currentData)) continue;
+        recorder.popped();
+        if (contains(marked, currentData)) {
+            recorder.stale();
+            continue;
+        }
         marked.insert(currentData);
+        recorder.settled();
+        if (!(currentData == source)) countFormedBranch++;
 
         for (const auto& edge : (*graph)[currentData]) {
+            recorder.scanned();
             if (contains(marked, edge.getTo())) continue;
 
-            if (edge.getWeight() < distTo[edge.getTo()]) {
-                distTo[edge.getTo()] = edge.getWeight();
+            const Distance cost = weight(edge);
+            if (cost < distTo[edge.getTo()]) {
+                distTo[edge.getTo()] = cost;
                 edgeTo[edge.getTo()] = edge;
-                minHeap.add(edge.getTo(), edge.getWeight());
-                countFormedBranch++;
+                minHeap.add(edge.getTo(), cost);
+                recorder.pushed(minHeap.size());
             }
         }
     }
 
+    recorder.phase(QueryStats::OUTPUT);
     for (const auto &[to, edge] : edgeTo)
         graf->addEdge(edge.getFrom(), to, edge.getWeight());
 }
 
-template<class T>
-double GraphAlgorithm<T>::sourceDistTo(const T &seek) {
+template<class T, class W, class G>
+typename GraphAlgorithm<T, W, G>::Distance GraphAlgorithm<T, W, G>::sourceDistTo(const T &seek) {
     return this->distTo[seek];
 }
 
-template<class T>
-bool GraphAlgorithm<T>::contains(const std::unordered_set<T> &set,const T &key) {
+template<class T, class W, class G>
+const QueryStats &GraphAlgorithm<T, W, G>::getStats() const {
+    return recorder.getStats();
+}
+
+template<class T, class W, class G>
+MemoryUsage GraphAlgorithm<T, W, G>::memoryUsage() const {
+    MemoryUsage usage;
+    if (scratch == &arena) {
+        // the arena keeps its blocks between searches, that is the real footprint
+        usage = arena.memoryUsage();
+    } else {
+        usage = MemoryUsage::of(edgeTo);
+        usage += MemoryUsage::of(distTo);
+        usage += MemoryUsage::of(marked);
+        usage += MemoryUsage::of(times);
+    }
+    usage += minHeap.memoryUsage();
+    usage += MemoryUsage::of(pathBuffer);
+    usage += MemoryUsage::of(frontier);
+    usage += MemoryUsage::of(frames);
+    usage += MemoryUsage::of(preorder);
+    usage += MemoryUsage::of(postorder);
+    return usage;
+}
+
+template<class T, class W, class G>
+size_t GraphAlgorithm<T, W, G>::getDiscoveryTime(const T &vertex) const {
+    auto it = times.find(vertex);
+    return it != times.end() ? it->second.discovery : NO_TIME;
+}
+
+template<class T, class W, class G>
+size_t GraphAlgorithm<T, W, G>::getFinishTime(const T &vertex) const {
+    auto it = times.find(vertex);
+    return it != times.end() ? it->second.finish : NO_TIME;
+}
+
+template<class T, class W, class G>
+const std::vector<T> &GraphAlgorithm<T, W, G>::getPreorder() const {
+    return preorder;
+}
+
+template<class T, class W, class G>
+const std::vector<T> &GraphAlgorithm<T, W, G>::getPostorder() const {
+    return postorder;
+}
+
+template<class T, class W, class G>
+bool GraphAlgorithm<T, W, G>::contains(const MarkSet &set,const T &key) {
     return set.find(key) != set.end();
 }
 
-template<class T>
-bool GraphAlgorithm<T>::contains(const std::unordered_map<T, Edge<T>> &map,const T &key) {
+template<class T, class W, class G>
+bool GraphAlgorithm<T, W, G>::contains(const EdgeMap &map,const T &key) {
     return map.find(key) != map.end();
 }
 
-template<class T>
-void GraphAlgorithm<T>::clearDataStructure() {
-    this->marked.clear();
-    this->edgeTo.clear();
-    this->distTo.clear();
+template<class T, class W, class G>
+void GraphAlgorithm<T, W, G>::clearDataStructure() {
+    if (scratch == &arena) {
+        // like clear(), keep the bucket counts so the next search does not rehash its way up again
+        const size_t markedBuckets = marked.bucket_count();
+        const size_t edgeToBuckets = edgeTo.bucket_count();
+        const size_t distToBuckets = distTo.bucket_count();
+        const size_t timesBuckets = times.bucket_count();
+
+        abandon(marked);
+        abandon(edgeTo);
+        abandon(distTo);
+        abandon(times);
+        arena.reset();
+
+        marked.rehash(markedBuckets);
+        edgeTo.rehash(edgeToBuckets);
+        distTo.rehash(distToBuckets);
+        times.rehash(timesBuckets);
+    } else {
+        this->marked.clear();
+        this->edgeTo.clear();
+        this->distTo.clear();
+        this->times.clear();
+    }
     this->minHeap.clear();
+    this->preorder.clear();
+    this->postorder.clear();
 }
 
-template<class T>
-void GraphAlgorithm<T>::relax(const Edge<T> &edge) {
-    if (distTo[edge.getFrom()] + edge.getWeight() < distTo[edge.getTo()]) {
-        distTo[edge.getTo()] = distTo[edge.getFrom()] + edge.getWeight();
+template<class T, class W, class G>
+template<class Container>
+void GraphAlgorithm<T, W, G>::abandon(Container &container) {
+    if constexpr (!std::is_trivially_destructible_v<typename Container::value_type>) container.~Container();
+    new (&container) Container(&arena);
+}
+
+template<class T, class W, class G>
+bool GraphAlgorithm<T, W, G>::relax(const Edge<T, W> &edge, Distance weight) {
+    const Distance candidate = distTo[edge.getFrom()] + weight;
+    if (candidate < distTo[edge.getTo()]) {
+        distTo[edge.getTo()] = candidate;
         edgeTo[edge.getTo()] = edge;
+        return true;
     }
+    return false;
 }
 
-template <typename T>
-bool GraphAlgorithm<T>::hasPathTo(const T &seek) {
+template<class T, class W, class G>
+bool GraphAlgorithm<T, W, G>::hasPathTo(const T &seek) {
     return contains(marked, seek);
 }
 
-template<class T>
-std::unique_ptr<std::stack<T>> GraphAlgorithm<T>::pathTo(const T &to) {
+template<class T, class W, class G>
+std::unique_ptr<std::stack<T>> GraphAlgorithm<T, W, G>::pathTo(const T &to) {
     auto paths = std::make_unique<std::stack<T>>();
     if (!hasPathTo(to)) {
         return paths;
     }
 
-    T seek = to;
-    while (edgeTo.find(seek) != edgeTo.end()) {
-        paths->push(seek);
-        seek = edgeTo[seek].getFrom();
-    }
-    paths->push(seek);
+    walkBack(to, [&](const T &vertex) { paths->push(vertex); });
     return paths;
 }
 
+template<class T, class W, class G>
+template<class Visit>
+void GraphAlgorithm<T, W, G>::walkBack(const T &to, Visit visit) {
+    const T *seek = &to;
+    for (auto it = edgeTo.find(*seek); it != edgeTo.end(); it = edgeTo.find(*seek)) {
+        visit(*seek);
+        seek = &it->second.getFrom();
+    }
+    visit(*seek);
+}
+
+template<class T, class W, class G>
+template<class OutputIt>
+OutputIt GraphAlgorithm<T, W, G>::pathTo(const T &to, OutputIt out) {
+    if (!pathInto(to, pathBuffer)) return out;
+    return std::copy(pathBuffer.begin(), pathBuffer.end(), out);
+}
+
+template<class T, class W, class G>
+bool GraphAlgorithm<T, W, G>::pathInto(const T &to, std::vector<T> &path) {
+    path.clear();
+    if (!hasPathTo(to)) return false;
+
+    walkBack(to, [&](const T &vertex) { path.push_back(vertex); });
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+template<class T, class W, class G>
+size_t GraphAlgorithm<T, W, G>::pathLength(const T &to) {
+    if (!hasPathTo(to)) return NO_PATH;
+
+    size_t vertices = 0;
+    walkBack(to, [&](const T &) { vertices++; });
+    return vertices - 1;
+}
+
 #endif //GRAPHALGORITHM_GRAPHALGORITHM_HPP
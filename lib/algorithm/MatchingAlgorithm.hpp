@@ -0,0 +1,417 @@
+#ifndef GRAPHALGORITHM_MATCHINGALGORITHM_HPP
+#define GRAPHALGORITHM_MATCHINGALGORITHM_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "DenseSnapshot.hpp"
+#include "Graph.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryUsage.hpp"
+
+/**
+ * Bipartiteness and maximum matching of an undirected graph.
+ *
+ * isBipartite 2-colors every component by BFS; the colors are the two sides the matching works
+ * with, so a Graph needs no explicit partition. hopcroftKarp then runs in O(E sqrt(V)): each
+ * phase finds, by one BFS from all the free left vertices, the length of the shortest augmenting
+ * paths, and augments along a maximal set of vertex-disjoint ones of that length by DFS, with a
+ * current-arc pointer per vertex.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges (ignored)
+ * @tparam G graph type, undirected
+ */
+template<class T, class W = double, class G = Graph<T, W>>
+class MatchingAlgorithm {
+public:
+    using VertexId = typename DenseSnapshot<T, W, G>::VertexId;
+    using EdgeId = typename DenseSnapshot<T, W, G>::EdgeId;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+private:
+    DenseSnapshot<T, W, G> snapshot;
+
+    // coloring: side 0 (left) or 1 (right), and the BFS tree that gives an odd cycle
+    std::vector<uint8_t> side;
+    std::vector<VertexId> parent;
+    std::vector<VertexId> depth;
+    std::vector<T> oddCycle;
+    bool colored = false;
+    bool bipartite = false;
+
+    std::vector<VertexId> mate;
+    size_t matchingSize = 0;
+
+    // Hopcroft-Karp: layer of each left vertex, current arc, BFS queue, DFS stack
+    std::vector<VertexId> layer;
+    VertexId shortest = NO_VERTEX;
+    std::vector<EdgeId> current;
+    std::vector<VertexId> queue;
+    std::vector<VertexId> stack;
+    Instrumentation recorder;
+
+    /**
+     * @brief Colors the graph if needed.
+     * @throw std::logic_error If it is not bipartite.
+     */
+    void requireSides();
+
+    /**
+     * @brief Walks the BFS tree from both ends of an edge joining two vertices of the same color
+     * up to their common ancestor.
+     */
+    void findOddCycle(VertexId u, VertexId w);
+
+    /**
+     * @brief Matches every left vertex to a free neighbor, if it has one, fewest neighbors first.
+     */
+    void greedy();
+
+    /**
+     * @brief BFS layers from the free left vertices.
+     * @return False if no augmenting path is left.
+     */
+    bool layers();
+
+    /**
+     * @brief Looks for an augmenting path from a free left vertex along increasing layers.
+     * @return True if the matching grew.
+     */
+    bool augment(VertexId root);
+
+public:
+    explicit MatchingAlgorithm(G *graph);
+    void changeGraph(G *graf);
+
+    /**
+     * @brief 2-colors every component by BFS.
+     * @return True if no edge joins two vertices of the same color; otherwise getOddCycle() holds
+     *         an odd cycle, which proves it.
+     */
+    bool isBipartite();
+
+    /**
+     * @return The vertices of an odd cycle found by the last isBipartite, each adjacent to the
+     *         next and the last to the first; empty if the graph is bipartite.
+     */
+    const std::vector<T> &getOddCycle() const;
+
+    /**
+     * @return True if the vertex is on the left side: in every component, the side of the first
+     *         vertex the coloring reached.
+     * @throw std::logic_error If the graph is not bipartite.
+     */
+    bool isLeft(const T &vertex);
+
+    /**
+     * @brief A maximal matching by a single greedy pass, fewest neighbors first; often within a
+     * few percent of the maximum.
+     * @throw std::logic_error If the graph is not bipartite.
+     */
+    MatchingAlgorithm<T, W, G> &greedyMatching();
+
+    /**
+     * @brief A maximum matching by Hopcroft-Karp.
+     *
+     * @param greedyStart True to start from greedyMatching, which leaves far fewer free vertices
+     *                    for the phases to deal with.
+     * @throw std::logic_error If the graph is not bipartite.
+     */
+    MatchingAlgorithm<T, W, G> &hopcroftKarp(bool greedyStart = true);
+
+    /**
+     * @return The number of edges of the last matching.
+     */
+    size_t getMatchingSize() const;
+
+    bool hasMate(const T &vertex) const;
+
+    /**
+     * @return The vertex matched to this one.
+     * @throw std::out_of_range If it is not matched.
+     */
+    const T &getMate(const T &vertex) const;
+
+    /**
+     * @return The matched pairs, left vertex first.
+     */
+    std::vector<std::pair<T, T>> getMatching() const;
+
+    /**
+     * @return Counters and phase timings of the last matching; all zero unless built with
+     *         GRAPHALGORITHM_INSTRUMENTATION.
+     */
+    const QueryStats &getStats() const;
+
+    /**
+     * @return The bytes of the snapshot and of the query state.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class T, class W, class G>
+MatchingAlgorithm<T, W, G>::MatchingAlgorithm(G *graph) : snapshot(graph) {}
+
+template<class T, class W, class G>
+void MatchingAlgorithm<T, W, G>::changeGraph(G *graf) {
+    snapshot.changeGraph(graf);
+    colored = false;
+    mate.clear();
+    matchingSize = 0;
+}
+
+template<class T, class W, class G>
+bool MatchingAlgorithm<T, W, G>::isBipartite() {
+    snapshot.refresh();
+    const auto &csr = snapshot.getCsr();
+    const size_t n = snapshot.size();
+    side.assign(n, 0);
+    parent.assign(n, NO_VERTEX);
+    depth.assign(n, NO_VERTEX);
+    oddCycle.clear();
+    bipartite = true;
+
+    for (VertexId root = 0; root < n && bipartite; root++) {
+        if (depth[root] != NO_VERTEX) continue;
+        depth[root] = 0;
+        queue.assign(1, root);
+        for (size_t head = 0; head < queue.size() && bipartite; head++) {
+            const VertexId u = queue[head];
+            for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+                const VertexId w = csr.getTarget(e);
+                if (depth[w] == NO_VERTEX) {
+                    depth[w] = depth[u] + 1;
+                    parent[w] = u;
+                    side[w] = side[u] ^ 1;
+                    queue.push_back(w);
+                } else if (side[w] == side[u]) {
+                    bipartite = false;
+                    findOddCycle(u, w);
+                    break;
+                }
+            }
+        }
+    }
+
+    colored = true;
+    return bipartite;
+}
+
+template<class T, class W, class G>
+void MatchingAlgorithm<T, W, G>::findOddCycle(VertexId u, VertexId w) {
+    // same color and BFS depths differ by at most 1, so same depth: climb both sides together
+    std::vector<VertexId> left, right;
+    while (u != w) {
+        left.push_back(u);
+        right.push_back(w);
+        u = parent[u];
+        w = parent[w];
+    }
+
+    for (VertexId v : left) oddCycle.push_back(snapshot.getVertex(v));
+    oddCycle.push_back(snapshot.getVertex(u));
+    for (auto it = right.rbegin(); it != right.rend(); ++it) oddCycle.push_back(snapshot.getVertex(*it));
+}
+
+template<class T, class W, class G>
+const std::vector<T> &MatchingAlgorithm<T, W, G>::getOddCycle() const {
+    return oddCycle;
+}
+
+template<class T, class W, class G>
+void MatchingAlgorithm<T, W, G>::requireSides() {
+    if (!colored) isBipartite();
+    if (!bipartite) throw std::logic_error("MatchingAlgorithm: the graph is not bipartite");
+}
+
+template<class T, class W, class G>
+bool MatchingAlgorithm<T, W, G>::isLeft(const T &vertex) {
+    requireSides();
+    const VertexId v = snapshot.find(vertex);
+    return v != NO_VERTEX && side[v] == 0;
+}
+
+template<class T, class W, class G>
+void MatchingAlgorithm<T, W, G>::greedy() {
+    const auto &csr = snapshot.getCsr();
+    const size_t n = snapshot.size();
+
+    // counting sort of the left vertices by degree
+    size_t maxDegree = 0;
+    for (VertexId u = 0; u < n; u++) maxDegree = std::max(maxDegree, csr.getDegree(u));
+    std::vector<size_t> start(maxDegree + 2, 0);
+    for (VertexId u = 0; u < n; u++)
+        if (side[u] == 0) start[csr.getDegree(u) + 1]++;
+    for (size_t d = 0; d <= maxDegree; d++) start[d + 1] += start[d];
+    queue.resize(start[maxDegree + 1]);
+    for (VertexId u = 0; u < n; u++)
+        if (side[u] == 0) queue[start[csr.getDegree(u)]++] = u;
+
+    for (VertexId u : queue) {
+        for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+            recorder.scanned();
+            const VertexId w = csr.getTarget(e);
+            if (mate[w] != NO_VERTEX) continue;
+            mate[u] = w;
+            mate[w] = u;
+            matchingSize++;
+            break;
+        }
+    }
+}
+
+template<class T, class W, class G>
+MatchingAlgorithm<T, W, G> &MatchingAlgorithm<T, W, G>::greedyMatching() {
+    auto query = recorder.scope();
+    requireSides();
+    mate.assign(snapshot.size(), NO_VERTEX);
+    matchingSize = 0;
+
+    recorder.phase(QueryStats::SEARCH);
+    greedy();
+    return *this;
+}
+
+template<class T, class W, class G>
+bool MatchingAlgorithm<T, W, G>::layers() {
+    const auto &csr = snapshot.getCsr();
+    const size_t n = snapshot.size();
+    layer.assign(n, NO_VERTEX);
+    queue.clear();
+    for (VertexId u = 0; u < n; u++) {
+        if (side[u] != 0 || mate[u] != NO_VERTEX) continue;
+        layer[u] = 0;
+        queue.push_back(u);
+    }
+
+    // stop at the layer of the first free right vertex: only shortest augmenting paths are used
+    shortest = NO_VERTEX;
+    for (size_t head = 0; head < queue.size(); head++) {
+        const VertexId u = queue[head];
+        if (layer[u] >= shortest) break;
+        recorder.settled();
+        for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+            recorder.scanned();
+            const VertexId next = mate[csr.getTarget(e)];
+            if (next == NO_VERTEX) {
+                shortest = layer[u];
+            } else if (layer[next] == NO_VERTEX) {
+                layer[next] = layer[u] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return shortest != NO_VERTEX;
+}
+
+template<class T, class W, class G>
+bool MatchingAlgorithm<T, W, G>::augment(VertexId root) {
+    // stack holds left vertices along the path; current[u] - 1 is the arc u took
+    const auto &csr = snapshot.getCsr();
+    stack.assign(1, root);
+    while (!stack.empty()) {
+        const VertexId u = stack.back();
+        bool advanced = false;
+        while (current[u] < csr.edgeEnd(u)) {
+            const VertexId w = csr.getTarget(current[u]++);
+            recorder.scanned();
+            const VertexId next = mate[w];
+            if (next == NO_VERTEX) {
+                if (layer[u] != shortest) continue;
+                // free right vertex: flip the path, each left vertex takes the right one it went through
+                for (size_t i = stack.size(); i-- > 0;) {
+                    const VertexId left = stack[i];
+                    const VertexId right = csr.getTarget(current[left] - 1);
+                    mate[left] = right;
+                    mate[right] = left;
+                }
+                matchingSize++;
+                return true;
+            }
+            if (layer[u] < shortest && layer[next] == layer[u] + 1) {
+                stack.push_back(next);
+                advanced = true;
+                break;
+            }
+        }
+        if (advanced) continue;
+
+        // dead end for this phase
+        layer[u] = NO_VERTEX;
+        stack.pop_back();
+    }
+    return false;
+}
+
+template<class T, class W, class G>
+MatchingAlgorithm<T, W, G> &MatchingAlgorithm<T, W, G>::hopcroftKarp(bool greedyStart) {
+    auto query = recorder.scope();
+    requireSides();
+    const auto &offsets = snapshot.getCsr().getOffsets();
+    const size_t n = snapshot.size();
+    mate.assign(n, NO_VERTEX);
+    matchingSize = 0;
+
+    recorder.phase(QueryStats::SEARCH);
+    if (greedyStart) greedy();
+    while (layers()) {
+        current.assign(offsets.begin(), offsets.end() - 1);
+        for (VertexId u = 0; u < n; u++)
+            if (side[u] == 0 && mate[u] == NO_VERTEX) augment(u);
+    }
+    return *this;
+}
+
+template<class T, class W, class G>
+size_t MatchingAlgorithm<T, W, G>::getMatchingSize() const {
+    return matchingSize;
+}
+
+template<class T, class W, class G>
+bool MatchingAlgorithm<T, W, G>::hasMate(const T &vertex) const {
+    const VertexId v = snapshot.find(vertex);
+    return v != NO_VERTEX && v < mate.size() && mate[v] != NO_VERTEX;
+}
+
+template<class T, class W, class G>
+const T &MatchingAlgorithm<T, W, G>::getMate(const T &vertex) const {
+    if (!hasMate(vertex)) throw std::out_of_range("MatchingAlgorithm: vertex not matched");
+    return snapshot.getVertex(mate[snapshot.find(vertex)]);
+}
+
+template<class T, class W, class G>
+std::vector<std::pair<T, T>> MatchingAlgorithm<T, W, G>::getMatching() const {
+    std::vector<std::pair<T, T>> pairs;
+    pairs.reserve(matchingSize);
+    for (VertexId u = 0; u < mate.size(); u++)
+        if (side[u] == 0 && mate[u] != NO_VERTEX) pairs.emplace_back(snapshot.getVertex(u), snapshot.getVertex(mate[u]));
+    return pairs;
+}
+
+template<class T, class W, class G>
+const QueryStats &MatchingAlgorithm<T, W, G>::getStats() const {
+    return recorder.getStats();
+}
+
+template<class T, class W, class G>
+MemoryUsage MatchingAlgorithm<T, W, G>::memoryUsage() const {
+    MemoryUsage usage = snapshot.memoryUsage();
+    usage += MemoryUsage::of(side);
+    usage += MemoryUsage::of(parent);
+    usage += MemoryUsage::of(depth);
+    usage += MemoryUsage::of(oddCycle);
+    usage += MemoryUsage::of(mate);
+    usage += MemoryUsage::of(layer);
+    usage += MemoryUsage::of(current);
+    usage += MemoryUsage::of(queue);
+    usage += MemoryUsage::of(stack);
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_MATCHINGALGORITHM_HPP
@@ -0,0 +1,491 @@
+#ifndef GRAPHALGORITHM_MINCOSTFLOWALGORITHM_HPP
+#define GRAPHALGORITHM_MINCOSTFLOWALGORITHM_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "DenseSnapshot.hpp"
+#include "Digraph.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryUsage.hpp"
+#include "PairHeap.hpp"
+#include "ResidualGraph.hpp"
+#include "WeightTraits.hpp"
+
+/**
+ * Minimum-cost flow between two vertices of a Digraph: edge weights are costs per unit of flow,
+ * capacities come from a function of the edge (1 by default, which makes assignment problems).
+ *
+ * The capacities are evaluated once per DenseSnapshot; every query packs the edges into a fresh
+ * ResidualGraph with costs, since costScaling adds an edge of its own, and starts from zero flow.
+ * Two engines:
+ *  - successiveShortestPaths: augments along shortest paths, each found by a Dijkstra on the
+ *    reduced costs c(u, v) + p(u) - p(v) of Johnson potentials p, which are non-negative, so
+ *    the search runs on the library PairHeap. O(F E log V) for a flow of value F;
+ *  - costScaling: Goldberg-Tarjan cost scaling, push-relabel refinements of epsilon-optimal
+ *    flows with epsilon divided by 8 each round. O(V^2 E log(V C)), independent of the flow
+ *    value, for large instances. Integer costs only.
+ * Both send as much flow as possible, up to a limit, at the lowest cost.
+ *
+ * A transport problem maps to one query: a super source with an edge of capacity supply(u) to
+ * every supplier u, a super sink with an edge of capacity demand(v) from every consumer v.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges, read as costs
+ * @tparam G graph type, a Digraph
+ */
+template<class T, class W = double, class G = Digraph<T, W>>
+class MinCostFlowAlgorithm {
+public:
+    /**
+     * Type of flows and capacities: 64-bit integers for integer weights, double otherwise.
+     */
+    using Flow = typename WeightTraits<W>::Distance;
+
+    /**
+     * Type of costs, reduced costs and potentials: the signed version of Flow.
+     */
+    using Cost = typename std::conditional_t<std::is_integral_v<Flow>, std::make_signed<Flow>, std::common_type<Flow>>::type;
+    using Residual = ResidualGraph<Flow, Cost>;
+    using VertexId = typename Residual::VertexId;
+    using ArcId = typename Residual::ArcId;
+    using EdgeId = typename DenseSnapshot<T, W, G>::EdgeId;
+    using Capacity = std::function<Flow(const Edge<T, W> &)>;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+    static constexpr ArcId NO_ARC = std::numeric_limits<ArcId>::max();
+
+    /**
+     * An edge of the graph with the flow it carries.
+     */
+    struct FlowEdge {
+        T from;
+        T to;
+        Flow capacity;
+        Cost cost;
+        Flow flow;
+    };
+
+private:
+    DenseSnapshot<T, W, G> snapshot;
+    Capacity capacity;
+    std::vector<typename Residual::Arc> arcs;
+
+    // costScaling adds one more edge after the arcs, from the sink back to the source
+    Residual residual;
+    VertexId source = NO_VERTEX;
+    VertexId sink = NO_VERTEX;
+    Flow flowValue = 0;
+    Cost totalCost = 0;
+
+    std::vector<Cost> potential;
+    std::vector<Cost> distTo;
+    std::vector<ArcId> parent;
+    std::vector<bool> marked;
+    PairHeap<VertexId, Cost> minHeap;
+
+    // costScaling: scaled costs, excesses (negative for a deficit) and the FIFO of active vertices
+    std::vector<Cost> scaled;
+    std::vector<Cost> excess;
+    std::vector<ArcId> current;
+    std::deque<VertexId> active;
+    std::vector<bool> queued;
+    Instrumentation recorder;
+
+    /**
+     * @brief Copies the edges if needed, resolves the terminals and builds the residual graph.
+     * @param returnEdge True to add the sink to source edge of costScaling.
+     * @return False if a terminal is not in the graph.
+     */
+    bool prepare(const T &from, const T &to, bool returnEdge, Flow limit);
+
+    /**
+     * @brief Bellman-Ford (queue based) from the source, for potentials under negative costs.
+     * @throw std::invalid_argument If a negative cycle is reachable from the source.
+     */
+    void initialPotentials();
+
+    /**
+     * @brief Dijkstra on reduced costs, stopped once the sink is settled; then moves the potentials
+     * so that the reduced costs stay non-negative.
+     * @return False if the sink is unreachable.
+     */
+    bool shortestPath();
+
+    /**
+     * @brief Turns an epsilon * 8 optimal flow into an epsilon optimal one.
+     */
+    void refine(Cost epsilon);
+
+    /**
+     * @brief Sums the cost of the flow on the real edges.
+     */
+    void computeCost();
+
+public:
+    /**
+     * @param capacity Capacity of each edge; every edge can carry one unit if omitted.
+     */
+    explicit MinCostFlowAlgorithm(G *graph, Capacity capacity = Capacity());
+    void changeGraph(G *graf);
+
+    /**
+     * @brief Minimum-cost flow by successive shortest paths with Johnson potentials.
+     *
+     * Negative costs are allowed (the first potentials then come from Bellman-Ford), negative
+     * cycles are not.
+     *
+     * @param limit Most flow to send, unbounded by default.
+     * @throw std::invalid_argument If source and sink are the same vertex or a negative cycle is
+     *        reachable from the source.
+     */
+    MinCostFlowAlgorithm<T, W, G> &successiveShortestPaths(const T &from, const T &to,
+                                                          Flow limit = std::numeric_limits<Flow>::max());
+
+    /**
+     * @brief Minimum-cost flow by cost scaling.
+     *
+     * The flow is a minimum-cost circulation with an extra edge from the sink back to the source,
+     * whose cost is below minus the cost of any simple path: flow value comes first, then cost.
+     * Negative cycles of the graph are saturated rather than rejected.
+     *
+     * @param limit Most flow to send, unbounded by default.
+     * @throw std::invalid_argument If source and sink are the same vertex.
+     */
+    MinCostFlowAlgorithm<T, W, G> &costScaling(const T &from, const T &to,
+                                               Flow limit = std::numeric_limits<Flow>::max());
+
+    /**
+     * @return The value of the last flow, 0 if a terminal was not in the graph.
+     */
+    Flow getFlowValue() const;
+
+    /**
+     * @return The total cost of the last flow.
+     */
+    Cost getCost() const;
+
+    /**
+     * @return Every edge of the graph with its flow.
+     */
+    std::vector<FlowEdge> getFlows() const;
+
+    /**
+     * @return Counters and phase timings of the last query; all zero unless built with
+     *         GRAPHALGORITHM_INSTRUMENTATION.
+     */
+    const QueryStats &getStats() const;
+
+    /**
+     * @return The bytes of the snapshot, the residual graph and the query state.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class T, class W, class G>
+MinCostFlowAlgorithm<T, W, G>::MinCostFlowAlgorithm(G *graph, Capacity capacity)
+    : snapshot(graph), capacity(std::move(capacity)) {
+    PairHeap<VertexId, Cost>::minPairHeap(minHeap);
+}
+
+template<class T, class W, class G>
+void MinCostFlowAlgorithm<T, W, G>::changeGraph(G *graf) {
+    snapshot.changeGraph(graf);
+}
+
+template<class T, class W, class G>
+bool MinCostFlowAlgorithm<T, W, G>::prepare(const T &from, const T &to, bool returnEdge, Flow limit) {
+    if (from == to) throw std::invalid_argument("MinCostFlowAlgorithm: source and sink are the same vertex");
+
+    if (snapshot.refresh()) {
+        const auto &csr = snapshot.getCsr();
+        arcs.clear();
+        arcs.reserve(csr.getEdgeCount());
+        for (VertexId u = 0; u < snapshot.size(); u++) {
+            for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+                const VertexId v = csr.getTarget(e);
+                const Flow amount = capacity
+                        ? capacity(Edge<T, W>(snapshot.getVertex(u), snapshot.getVertex(v), csr.getWeight(e)))
+                        : Flow(1);
+                arcs.push_back({u, v, amount, Cost(csr.getWeight(e))});
+            }
+        }
+    }
+
+    flowValue = 0;
+    totalCost = 0;
+    source = snapshot.find(from);
+    sink = snapshot.find(to);
+    const bool found = source != NO_VERTEX && sink != NO_VERTEX;
+    if (!found || !returnEdge) {
+        residual = Residual::fromArcs(snapshot.size(), arcs, true);
+        return found;
+    }
+
+    // its capacity bounds the flow, its cost is below minus the cost of any simple path
+    Flow bound = 0;
+    Cost largest = 0;
+    for (const auto &arc : arcs) {
+        if (arc.from == source) bound += arc.capacity;
+        largest = std::max(largest, arc.cost < 0 ? -arc.cost : arc.cost);
+    }
+    arcs.push_back({sink, source, std::min(bound, limit), -(Cost(snapshot.size()) * largest + 1)});
+    residual = Residual::fromArcs(snapshot.size(), arcs, true);
+    arcs.pop_back();
+    return true;
+}
+
+template<class T, class W, class G>
+void MinCostFlowAlgorithm<T, W, G>::initialPotentials() {
+    const size_t n = snapshot.size();
+    potential.assign(n, 0);
+
+    bool negative = false;
+    for (ArcId a = 0; a < residual.getArcCount() && !negative; a++)
+        negative = residual.getResidual(a) > 0 && residual.getCost(a) < 0;
+    if (!negative) return;
+
+    // shortest distances from the source; vertices it cannot reach keep potential 0 and are never searched
+    std::vector<Cost> distance(n, std::numeric_limits<Cost>::max());
+    std::vector<size_t> rounds(n, 0);
+    queued.assign(n, false);
+    active.clear();
+    distance[source] = 0;
+    active.push_back(source);
+    queued[source] = true;
+    while (!active.empty()) {
+        const VertexId u = active.front();
+        active.pop_front();
+        queued[u] = false;
+        for (ArcId a = residual.arcBegin(u); a < residual.arcEnd(u); a++) {
+            if (!(residual.getResidual(a) > 0)) continue;
+            const VertexId w = residual.getHead(a);
+            const Cost candidate = distance[u] + residual.getCost(a);
+            if (!(candidate < distance[w])) continue;
+            distance[w] = candidate;
+            if (queued[w]) continue;
+            if (++rounds[w] > n) throw std::invalid_argument("MinCostFlowAlgorithm: negative cycle");
+            queued[w] = true;
+            active.push_back(w);
+        }
+    }
+
+    for (VertexId v = 0; v < n; v++)
+        if (distance[v] != std::numeric_limits<Cost>::max()) potential[v] = distance[v];
+}
+
+template<class T, class W, class G>
+bool MinCostFlowAlgorithm<T, W, G>::shortestPath() {
+    const size_t n = snapshot.size();
+    distTo.assign(n, std::numeric_limits<Cost>::max());
+    parent.assign(n, NO_ARC);
+    marked.assign(n, false);
+    minHeap.clear();
+
+    distTo[source] = 0;
+    minHeap.add(source, 0);
+    recorder.pushed(minHeap.size());
+    while (!minHeap.isEmpty()) {
+        const VertexId u = minHeap.pool();
+        recorder.popped();
+        if (marked[u]) {
+            recorder.stale();
+            continue;
+        }
+        marked[u] = true;
+        recorder.settled();
+        if (u == sink) break;
+
+        for (ArcId a = residual.arcBegin(u); a < residual.arcEnd(u); a++) {
+            recorder.scanned();
+            if (!(residual.getResidual(a) > 0)) continue;
+            const VertexId w = residual.getHead(a);
+            const Cost reduced = residual.getCost(a) + potential[u] - potential[w];
+            const Cost candidate = distTo[u] + reduced;
+            if (marked[w] || !(candidate < distTo[w])) continue;
+            distTo[w] = candidate;
+            parent[w] = a;
+            minHeap.add(w, candidate);
+            recorder.pushed(minHeap.size());
+        }
+    }
+    if (!marked[sink]) return false;
+
+    // vertices settled after the sink would have been at least as far: charge them its distance
+    const Cost reach = distTo[sink];
+    for (VertexId v = 0; v < n; v++) potential[v] += marked[v] ? distTo[v] : reach;
+    return true;
+}
+
+template<class T, class W, class G>
+MinCostFlowAlgorithm<T, W, G> &MinCostFlowAlgorithm<T, W, G>::successiveShortestPaths(const T &from, const T &to,
+                                                                                      Flow limit) {
+    auto query = recorder.scope();
+    if (!prepare(from, to, false, limit)) return *this;
+    initialPotentials();
+
+    recorder.phase(QueryStats::SEARCH);
+    while (flowValue < limit && shortestPath()) {
+        Flow bottleneck = limit - flowValue;
+        for (VertexId v = sink; v != source; v = residual.getHead(residual.getReverse(parent[v])))
+            bottleneck = std::min(bottleneck, residual.getResidual(parent[v]));
+        for (VertexId v = sink; v != source; v = residual.getHead(residual.getReverse(parent[v])))
+            residual.push(parent[v], bottleneck);
+        flowValue += bottleneck;
+    }
+
+    recorder.phase(QueryStats::OUTPUT);
+    computeCost();
+    return *this;
+}
+
+template<class T, class W, class G>
+MinCostFlowAlgorithm<T, W, G> &MinCostFlowAlgorithm<T, W, G>::costScaling(const T &from, const T &to, Flow limit) {
+    static_assert(WeightTraits<W>::INTEGRAL, "costScaling needs integer costs");
+
+    auto query = recorder.scope();
+    if (!prepare(from, to, true, limit)) return *this;
+    const size_t n = snapshot.size();
+
+    // costs scaled by n + 1: an epsilon of 1 is then below 1 / n of a real unit, which is optimal
+    scaled.resize(residual.getArcCount());
+    Cost epsilon = 1;
+    for (ArcId a = 0; a < residual.getArcCount(); a++) {
+        scaled[a] = residual.getCost(a) * Cost(n + 1);
+        epsilon = std::max(epsilon, scaled[a] < 0 ? -scaled[a] : scaled[a]);
+    }
+    potential.assign(n, 0);
+    excess.assign(n, 0);
+    current.resize(n);
+    queued.assign(n, false);
+
+    recorder.phase(QueryStats::SEARCH);
+    do {
+        epsilon = std::max<Cost>(1, epsilon / 8);
+        refine(epsilon);
+    } while (epsilon > 1);
+
+    recorder.phase(QueryStats::OUTPUT);
+    flowValue = residual.getFlow(arcs.size());
+    computeCost();
+    return *this;
+}
+
+template<class T, class W, class G>
+void MinCostFlowAlgorithm<T, W, G>::refine(Cost epsilon) {
+    const size_t n = snapshot.size();
+    auto reduced = [&](VertexId u, ArcId a) { return scaled[a] + potential[u] - potential[residual.getHead(a)]; };
+
+    // saturating every arc of negative reduced cost makes the flow 0-optimal, at the price of excesses
+    for (VertexId u = 0; u < n; u++) {
+        for (ArcId a = residual.arcBegin(u); a < residual.arcEnd(u); a++) {
+            const Flow amount = residual.getResidual(a);
+            if (!(amount > 0) || reduced(u, a) >= 0) continue;
+            residual.push(a, amount);
+            excess[u] -= Cost(amount);
+            excess[residual.getHead(a)] += Cost(amount);
+        }
+    }
+
+    for (VertexId v = 0; v < n; v++) {
+        current[v] = residual.arcBegin(v);
+        if (excess[v] > 0 && !queued[v]) {
+            queued[v] = true;
+            active.push_back(v);
+        }
+    }
+
+    while (!active.empty()) {
+        const VertexId v = active.front();
+        active.pop_front();
+        queued[v] = false;
+        recorder.settled();
+
+        while (excess[v] > 0) {
+            ArcId &a = current[v];
+            const ArcId end = residual.arcEnd(v);
+            for (; a < end; a++) {
+                recorder.scanned();
+                if (!(residual.getResidual(a) > 0) || reduced(v, a) >= 0) continue;
+
+                const VertexId w = residual.getHead(a);
+                const Flow amount = std::min(Flow(excess[v]), residual.getResidual(a));
+                residual.push(a, amount);
+                excess[v] -= Cost(amount);
+                excess[w] += Cost(amount);
+                if (excess[w] > 0 && !queued[w]) {
+                    queued[w] = true;
+                    active.push_back(w);
+                }
+                if (excess[v] == 0) break;
+            }
+            if (a < end) break;
+
+            // relabel: lower v just enough that its cheapest residual arc gets a reduced cost of -epsilon
+            Cost highest = std::numeric_limits<Cost>::lowest();
+            for (ArcId b = residual.arcBegin(v); b < end; b++)
+                if (residual.getResidual(b) > 0) highest = std::max(highest, potential[residual.getHead(b)] - scaled[b]);
+            potential[v] = highest - epsilon;
+            current[v] = residual.arcBegin(v);
+        }
+    }
+}
+
+template<class T, class W, class G>
+void MinCostFlowAlgorithm<T, W, G>::computeCost() {
+    totalCost = 0;
+    for (size_t i = 0; i < arcs.size(); i++)
+        totalCost += Cost(residual.getFlow(i)) * residual.getCost(residual.getEdgeArc(i));
+}
+
+template<class T, class W, class G>
+typename MinCostFlowAlgorithm<T, W, G>::Flow MinCostFlowAlgorithm<T, W, G>::getFlowValue() const {
+    return flowValue;
+}
+
+template<class T, class W, class G>
+typename MinCostFlowAlgorithm<T, W, G>::Cost MinCostFlowAlgorithm<T, W, G>::getCost() const {
+    return totalCost;
+}
+
+template<class T, class W, class G>
+std::vector<typename MinCostFlowAlgorithm<T, W, G>::FlowEdge> MinCostFlowAlgorithm<T, W, G>::getFlows() const {
+    std::vector<FlowEdge> flows;
+    flows.reserve(arcs.size());
+    for (size_t i = 0; i < arcs.size(); i++) {
+        const ArcId a = residual.getEdgeArc(i);
+        flows.push_back({snapshot.getVertex(residual.getHead(residual.getReverse(a))), snapshot.getVertex(residual.getHead(a)),
+                         residual.getCapacity(i), residual.getCost(a), residual.getFlow(i)});
+    }
+    return flows;
+}
+
+template<class T, class W, class G>
+const QueryStats &MinCostFlowAlgorithm<T, W, G>::getStats() const {
+    return recorder.getStats();
+}
+
+template<class T, class W, class G>
+MemoryUsage MinCostFlowAlgorithm<T, W, G>::memoryUsage() const {
+    MemoryUsage usage = residual.memoryUsage();
+    usage += snapshot.memoryUsage();
+    usage += MemoryUsage::of(arcs);
+    usage += MemoryUsage::of(potential);
+    usage += MemoryUsage::of(distTo);
+    usage += MemoryUsage::of(parent);
+    usage += MemoryUsage::of(marked);
+    usage += minHeap.memoryUsage();
+    usage += MemoryUsage::of(scaled);
+    usage += MemoryUsage::of(excess);
+    usage += MemoryUsage::of(current);
+    usage += MemoryUsage::of(queued);
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_MINCOSTFLOWALGORITHM_HPP
@@ -0,0 +1,438 @@
+#ifndef GRAPHALGORITHM_PAGERANKALGORITHM_HPP
+#define GRAPHALGORITHM_PAGERANKALGORITHM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "DenseSnapshot.hpp"
+#include "Digraph.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryUsage.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Where the rank of a vertex without out-edges goes.
+ */
+enum class DanglingPolicy {
+    /**
+     * Spread like a teleport: evenly over every vertex for pageRank, back to the seed for
+     * personalizedPageRank. The ranks sum to 1.
+     */
+    UNIFORM,
+
+    /**
+     * Kept by the vertex, as if it had a single edge to itself. The ranks sum to 1.
+     */
+    SELF_LOOP,
+
+    /**
+     * Lost: the ranks sum to less than 1, by the share that ends on dangling vertices.
+     */
+    DROP
+};
+
+/**
+ * Settings of PageRankAlgorithm::pageRank and PageRankAlgorithm::personalizedPageRank.
+ */
+struct PageRankOptions {
+    /**
+     * Probability of following an edge rather than teleporting.
+     */
+    double damping = 0.85;
+
+    /**
+     * pageRank stops when the ranks moved by less than this in an iteration (L1 norm).
+     */
+    double tolerance = 1e-9;
+    size_t maxIterations = 100;
+
+    /**
+     * personalizedPageRank pushes from a vertex while its residual exceeds this much per out-edge.
+     */
+    double epsilon = 1e-7;
+
+    DanglingPolicy dangling = DanglingPolicy::UNIFORM;
+
+    /**
+     * Threads and grain of the pageRank iterations.
+     */
+    ParallelOptions parallel;
+};
+
+/**
+ * PageRank and personalized PageRank of a directed graph; edge weights are ignored.
+ *
+ * Next to the DenseSnapshot, which holds the edges by tail (CSR), the first query builds their
+ * transpose by head (CSC) for the gather.
+ *
+ * pageRank is pull-based power iteration: a vertex sums the shares of its in-neighbors, read
+ * from a contribution array (rank divided by out-degree) computed once per iteration, so every
+ * vertex is written by a single thread without atomics and the gather streams over the CSC. Each
+ * iteration is two passes of ThreadPool::parallelReduce, the first also summing the dangling
+ * rank, the second also the change of the ranks.
+ *
+ * personalizedPageRank is forward push (Andersen, Chung and Lang): it only touches the
+ * neighbourhood of the seed where the walk still carries more than epsilon per edge, so a query
+ * costs O(1 / (epsilon (1 - damping))) whatever the size of the graph.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges (ignored)
+ * @tparam G graph type
+ */
+template<class T, class W = double, class G = Digraph<T, W>>
+class PageRankAlgorithm {
+public:
+    using VertexId = typename DenseSnapshot<T, W, G>::VertexId;
+    using EdgeId = typename DenseSnapshot<T, W, G>::EdgeId;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+private:
+    DenseSnapshot<T, W, G> snapshot;
+    std::vector<size_t> inOffsets;
+    std::vector<VertexId> sources;
+    std::vector<double> inverseDegree;
+
+    std::vector<double> rank;
+    std::vector<double> next;
+    std::vector<double> contribution;
+    size_t iterations = 0;
+    double residualNorm = 0;
+
+    // forward push: residual mass, flags (TOUCHED, QUEUED) and the vertices to clean up
+    static constexpr uint8_t TOUCHED = 1;
+    static constexpr uint8_t QUEUED = 2;
+    std::vector<double> residual;
+    std::vector<uint8_t> flags;
+    std::vector<VertexId> touched;
+    std::vector<VertexId> queue;
+    size_t head = 0;
+    bool personalized = false;
+    Instrumentation recorder;
+
+    /**
+     * @brief Takes the snapshot and its transpose, if not done yet.
+     */
+    void build();
+
+    /**
+     * @throw std::invalid_argument If the damping is not in [0, 1) or a threshold is negative.
+     */
+    static void checkOptions(const PageRankOptions &options);
+
+    /**
+     * @brief Adds mass to the residual of v and queues v once it is worth a push.
+     */
+    void addResidual(VertexId v, double mass, double epsilon);
+
+public:
+    explicit PageRankAlgorithm(G *graph);
+    void changeGraph(G *graf);
+
+    /**
+     * @brief The PageRank of every vertex, starting from the uniform distribution.
+     *
+     * @param options Damping, stopping rule, dangling policy and threads.
+     * @throw std::invalid_argument If the options are out of range.
+     */
+    PageRankAlgorithm<T, W, G> &pageRank(const PageRankOptions &options = PageRankOptions());
+
+    /**
+     * @brief The PageRank personalized to a single vertex: the teleports all go back to the seed.
+     *
+     * Every estimate is below its exact value, by getResidual() at most in total.
+     *
+     * @param seed Start of the walks; a vertex not in the graph gives all zeros.
+     * @param options Damping, epsilon and dangling policy; tolerance and threads are not used.
+     * @throw std::invalid_argument If the options are out of range.
+     */
+    PageRankAlgorithm<T, W, G> &personalizedPageRank(const T &seed,
+                                                     const PageRankOptions &options = PageRankOptions());
+
+    /**
+     * @return The rank of the vertex after the last query, 0 if not in the graph.
+     */
+    double getRank(const T &vertex) const;
+
+    /**
+     * @return The count vertices of highest rank after the last query, highest first, ties in an
+     *         unspecified but stable order; after personalizedPageRank only those it reached.
+     */
+    std::vector<std::pair<T, double>> getTop(size_t count) const;
+
+    /**
+     * @return The iterations of the last pageRank, or the pushes of the last personalizedPageRank.
+     */
+    size_t getIterations() const;
+
+    /**
+     * @return After pageRank, the L1 change of its last iteration; after personalizedPageRank, the
+     *         mass left unpushed, which bounds the L1 error of the estimates.
+     */
+    double getResidual() const;
+
+    /**
+     * @return Counters and phase timings of the last query; all zero unless built with
+     *         GRAPHALGORITHM_INSTRUMENTATION. The pageRank passes run on several threads and
+     *         only record phases.
+     */
+    const QueryStats &getStats() const;
+
+    /**
+     * @return The bytes of the snapshot, its transpose and the query state.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class T, class W, class G>
+PageRankAlgorithm<T, W, G>::PageRankAlgorithm(G *graph) : snapshot(graph) {}
+
+template<class T, class W, class G>
+void PageRankAlgorithm<T, W, G>::changeGraph(G *graf) {
+    snapshot.changeGraph(graf);
+}
+
+template<class T, class W, class G>
+void PageRankAlgorithm<T, W, G>::build() {
+    if (!snapshot.refresh()) return;
+    const auto &csr = snapshot.getCsr();
+    const size_t n = snapshot.size();
+
+    // transpose by counting sort: the in-neighbors of v come out in increasing order
+    inOffsets.assign(n + 1, 0);
+    for (VertexId w : csr.getTargets()) inOffsets[w + 1]++;
+    for (size_t v = 0; v < n; v++) inOffsets[v + 1] += inOffsets[v];
+    sources.resize(csr.getEdgeCount());
+    std::vector<size_t> cursor(inOffsets.begin(), inOffsets.end() - 1);
+    for (VertexId u = 0; u < n; u++)
+        for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) sources[cursor[csr.getTarget(e)]++] = u;
+
+    inverseDegree.resize(n);
+    for (VertexId u = 0; u < n; u++) {
+        const size_t degree = csr.getDegree(u);
+        inverseDegree[u] = degree == 0 ? 0.0 : 1.0 / (double) degree;
+    }
+
+    rank.assign(n, 0.0);
+    residual.assign(n, 0.0);
+    flags.assign(n, 0);
+    touched.clear();
+    personalized = false;
+}
+
+template<class T, class W, class G>
+void PageRankAlgorithm<T, W, G>::checkOptions(const PageRankOptions &options) {
+    if (!(options.damping >= 0.0 && options.damping < 1.0))
+        throw std::invalid_argument("PageRankAlgorithm: damping out of [0, 1)");
+    if (!(options.tolerance >= 0.0) || !(options.epsilon >= 0.0))
+        throw std::invalid_argument("PageRankAlgorithm: negative threshold");
+}
+
+template<class T, class W, class G>
+PageRankAlgorithm<T, W, G> &PageRankAlgorithm<T, W, G>::pageRank(const PageRankOptions &options) {
+    auto query = recorder.scope();
+    checkOptions(options);
+    build();
+    const auto &csr = snapshot.getCsr();
+    const size_t n = snapshot.size();
+    const double d = options.damping;
+    ThreadPool &pool = ThreadPool::global();
+
+    rank.assign(n, n == 0 ? 0.0 : 1.0 / (double) n);
+    next.resize(n);
+    contribution.resize(n);
+    personalized = false;
+    iterations = 0;
+    residualNorm = 0;
+
+    recorder.phase(QueryStats::SEARCH);
+    while (n > 0 && iterations < options.maxIterations) {
+        iterations++;
+
+        const double dangling = pool.parallelReduce(size_t(0), n, 0.0, [&](size_t first, size_t last) {
+            double lost = 0.0;
+            for (size_t u = first; u < last; u++) {
+                contribution[u] = rank[u] * inverseDegree[u];
+                if (csr.getDegree(u) == 0) lost += rank[u];
+            }
+            return lost;
+        }, [](double a, double b) { return a + b; }, options.parallel);
+
+        double base = (1.0 - d) / (double) n;
+        if (options.dangling == DanglingPolicy::UNIFORM) base += d * dangling / (double) n;
+        const bool selfLoop = options.dangling == DanglingPolicy::SELF_LOOP;
+
+        residualNorm = pool.parallelReduce(size_t(0), n, 0.0, [&](size_t first, size_t last) {
+            double change = 0.0;
+            for (size_t v = first; v < last; v++) {
+                // four independent sums: the gather is latency bound and the additions may not be reordered
+                const VertexId *in = sources.data() + inOffsets[v];
+                const size_t count = inOffsets[v + 1] - inOffsets[v];
+                double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4) {
+                    s0 += contribution[in[i]];
+                    s1 += contribution[in[i + 1]];
+                    s2 += contribution[in[i + 2]];
+                    s3 += contribution[in[i + 3]];
+                }
+                for (; i < count; i++) s0 += contribution[in[i]];
+
+                double value = base + d * ((s0 + s1) + (s2 + s3));
+                if (selfLoop && csr.getDegree(v) == 0) value += d * rank[v];
+                change += std::abs(value - rank[v]);
+                next[v] = value;
+            }
+            return change;
+        }, [](double a, double b) { return a + b; }, options.parallel);
+
+        rank.swap(next);
+        if (residualNorm < options.tolerance) break;
+    }
+    return *this;
+}
+
+template<class T, class W, class G>
+void PageRankAlgorithm<T, W, G>::addResidual(VertexId v, double mass, double epsilon) {
+    if (!(flags[v] & TOUCHED)) {
+        flags[v] |= TOUCHED;
+        touched.push_back(v);
+    }
+    residual[v] += mass;
+
+    const size_t degree = std::max<size_t>(1, snapshot.getCsr().getDegree(v));
+    if (!(flags[v] & QUEUED) && residual[v] > epsilon * (double) degree) {
+        flags[v] |= QUEUED;
+        queue.push_back(v);
+        recorder.pushed(queue.size() - head);
+    }
+}
+
+template<class T, class W, class G>
+PageRankAlgorithm<T, W, G> &PageRankAlgorithm<T, W, G>::personalizedPageRank(const T &seed,
+                                                                             const PageRankOptions &options) {
+    auto query = recorder.scope();
+    checkOptions(options);
+    build();
+    const auto &csr = snapshot.getCsr();
+    const double d = options.damping;
+
+    // only the vertices of the previous push are dirty, unless pageRank filled every rank since
+    for (VertexId v : touched) {
+        rank[v] = 0.0;
+        residual[v] = 0.0;
+        flags[v] = 0;
+    }
+    if (!personalized) rank.assign(snapshot.size(), 0.0);
+    touched.clear();
+    queue.clear();
+    head = 0;
+    personalized = true;
+    iterations = 0;
+    residualNorm = 0;
+
+    const VertexId source = snapshot.find(seed);
+    if (source == NO_VERTEX) return *this;
+
+    recorder.phase(QueryStats::SEARCH);
+    addResidual(source, 1.0, options.epsilon);
+    while (head < queue.size()) {
+        const VertexId u = queue[head++];
+        if (head >= 4096 && 2 * head >= queue.size()) {
+            // drop the consumed half: the queue stays within twice its live size
+            queue.erase(queue.begin(), queue.begin() + (std::ptrdiff_t) head);
+            head = 0;
+        }
+        flags[u] &= (uint8_t) ~QUEUED;
+        recorder.popped();
+
+        const double mass = residual[u];
+        residual[u] = 0.0;
+        rank[u] += (1.0 - d) * mass;
+        iterations++;
+        recorder.settled();
+
+        const size_t degree = csr.getDegree(u);
+        if (degree == 0) {
+            if (options.dangling == DanglingPolicy::UNIFORM) addResidual(source, d * mass, options.epsilon);
+            else if (options.dangling == DanglingPolicy::SELF_LOOP) rank[u] += d * mass;
+            continue;
+        }
+
+        const double share = d * mass * inverseDegree[u];
+        for (EdgeId e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+            recorder.scanned();
+            addResidual(csr.getTarget(e), share, options.epsilon);
+        }
+    }
+
+    for (VertexId v : touched) residualNorm += residual[v];
+    return *this;
+}
+
+template<class T, class W, class G>
+double PageRankAlgorithm<T, W, G>::getRank(const T &vertex) const {
+    const VertexId v = snapshot.find(vertex);
+    if (v == NO_VERTEX || v >= rank.size()) return 0.0;
+    return rank[v];
+}
+
+template<class T, class W, class G>
+std::vector<std::pair<T, double>> PageRankAlgorithm<T, W, G>::getTop(size_t count) const {
+    std::vector<VertexId> candidates;
+    if (personalized) {
+        for (VertexId v : touched)
+            if (rank[v] > 0.0) candidates.push_back(v);
+    } else {
+        candidates.resize(rank.size());
+        for (VertexId v = 0; v < rank.size(); v++) candidates[v] = v;
+    }
+
+    auto higher = [&](VertexId a, VertexId b) { return rank[a] != rank[b] ? rank[a] > rank[b] : a < b; };
+    count = std::min(count, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), higher);
+
+    std::vector<std::pair<T, double>> top;
+    top.reserve(count);
+    for (size_t i = 0; i < count; i++) top.emplace_back(snapshot.getVertex(candidates[i]), rank[candidates[i]]);
+    return top;
+}
+
+template<class T, class W, class G>
+size_t PageRankAlgorithm<T, W, G>::getIterations() const {
+    return iterations;
+}
+
+template<class T, class W, class G>
+double PageRankAlgorithm<T, W, G>::getResidual() const {
+    return residualNorm;
+}
+
+template<class T, class W, class G>
+const QueryStats &PageRankAlgorithm<T, W, G>::getStats() const {
+    return recorder.getStats();
+}
+
+template<class T, class W, class G>
+MemoryUsage PageRankAlgorithm<T, W, G>::memoryUsage() const {
+    MemoryUsage usage = snapshot.memoryUsage();
+    usage += MemoryUsage::of(inOffsets);
+    usage += MemoryUsage::of(sources);
+    usage += MemoryUsage::of(inverseDegree);
+    usage += MemoryUsage::of(rank);
+    usage += MemoryUsage::of(next);
+    usage += MemoryUsage::of(contribution);
+    usage += MemoryUsage::of(residual);
+    usage += MemoryUsage::of(flags);
+    usage += MemoryUsage::of(touched);
+    usage += MemoryUsage::of(queue);
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_PAGERANKALGORITHM_HPP
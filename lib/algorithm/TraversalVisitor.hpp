@@ -0,0 +1,61 @@
+#ifndef GRAPHALGORITHM_TRAVERSALVISITOR_HPP
+#define GRAPHALGORITHM_TRAVERSALVISITOR_HPP
+
+#include <cstddef>
+
+#include "Edge.hpp"
+
+/**
+ * What a traversal does after a visitor callback.
+ */
+enum class VisitAction {
+    /**
+     * Go on as usual.
+     */
+    CONTINUE,
+
+    /**
+     * End the whole traversal now.
+     */
+    STOP,
+
+    /**
+     * From onDiscover: keep the vertex as reached but do not expand its edges.
+     * From onExamineEdge: do not follow this edge. From onFinish: same as CONTINUE.
+     */
+    PRUNE
+};
+
+/**
+ * Base of the visitors given to GraphAlgorithm::breadthFirstVisit and depthFirstVisit.
+ *
+ * Derive from it and declare only the callbacks you need, with the same signatures: the
+ * traversal is a template over the visitor type, so the calls are resolved at compile time and
+ * inlined, and the callbacks you leave out cost nothing. No virtual function is involved.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges
+ */
+template<class T, class W = double>
+struct TraversalVisitor {
+    /**
+     * @brief Called once per vertex, when it is reached for the first time.
+     *
+     * @param vertex The discovered vertex.
+     * @param depth Its distance in edges from the source along the traversal tree (0 for the source).
+     */
+    VisitAction onDiscover(const T & /*vertex*/, size_t /*depth*/) { return VisitAction::CONTINUE; }
+
+    /**
+     * @brief Called for every edge leaving an expanded vertex, before its head is looked at.
+     */
+    VisitAction onExamineEdge(const Edge<T, W> & /*edge*/) { return VisitAction::CONTINUE; }
+
+    /**
+     * @brief Called once per discovered vertex, when all of its edges have been examined (for a
+     * pruned vertex, right after its discovery).
+     */
+    VisitAction onFinish(const T & /*vertex*/) { return VisitAction::CONTINUE; }
+};
+
+#endif //GRAPHALGORITHM_TRAVERSALVISITOR_HPP
@@ -0,0 +1,311 @@
+#ifndef GRAPHALGORITHM_CONCURRENTGRAPHBUILDER_HPP
+#define GRAPHALGORITHM_CONCURRENTGRAPHBUILDER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "CsrGraph.hpp"
+#include "Digraph.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * A GraphBuilder that many threads can feed at the same time.
+ *
+ * Every producer thread appends to a buffer of its own, on its own cache line, found through a
+ * thread-local cache: addVertex and addEdge take no lock and threads share nothing, whatever the
+ * degree distribution (a hub fed by every thread costs the same as any other vertex). The
+ * builder lock is only taken the first time a thread feeds it, and again when a thread
+ * alternates between several builders.
+ *
+ * Once ingestion is over, the builder is finalized into a Graph or Digraph (through
+ * Graph::bulkInsert) or into the compact CsrGraph layout. For the CSR, the grouping by vertex is
+ * done in parallel at that point: every buffer splits its vertices into parts by hash, every part
+ * numbers its own with no lock, then every buffer translates its edges.
+ *
+ * addVertex, addEdge and size are thread-safe; reserve and the build methods are not and must
+ * run once every producer is done.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges
+ */
+template<class T, class W = double>
+class ConcurrentGraphBuilder {
+    struct alignas(64) Buffer {
+        std::thread::id owner;
+        std::vector<std::tuple<T, T, W>> edges;
+        std::vector<T> vertices;
+        // edges.size(), published for size() while the owner keeps appending
+        std::atomic<size_t> queued{0};
+    };
+
+    mutable std::mutex lock;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    size_t share = 0;
+    size_t partCount;
+    unsigned threads;
+
+    // keys the thread-local cache of local(): a new one on every clear, never reused
+    uint64_t serial;
+
+    static uint64_t nextSerial();
+
+    /**
+     * @brief The buffer of the calling thread, registered on first use.
+     */
+    Buffer &local();
+
+    size_t partOf(const T &vertex) const;
+
+    /**
+     * @brief Runs task(i) for every i in [0, count) on the shared pool, with at most the builder thread count.
+     */
+    template<class Task>
+    void forEach(size_t count, Task task);
+
+    template<class G>
+    void fill(G &graph);
+
+    void clear();
+
+public:
+    /**
+     * @param threads Expected number of producer threads, also used to finalize; 0 means
+     *                std::thread::hardware_concurrency().
+     */
+    explicit ConcurrentGraphBuilder(unsigned threads = 0);
+
+    /**
+     * @brief Reserves room for the given total number of edges, spread evenly over the expected threads.
+     */
+    void reserve(size_t edges);
+
+    /**
+     * @brief Queues a vertex, useful for vertices that have no edge. Thread-safe.
+     */
+    ConcurrentGraphBuilder<T, W> &addVertex(const T &vertex);
+
+    /**
+     * @brief Queues an edge. Thread-safe. For an undirected build (u, v) and (v, u) are the same edge.
+     */
+    ConcurrentGraphBuilder<T, W> &addEdge(const T &from, const T &to, W weight);
+
+    /**
+     * @return The number of edges queued so far.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Builds an undirected graph from everything queued and empties the builder.
+     *
+     * @note When the same edge was queued several times by different threads, which weight is
+     * kept is unspecified.
+     */
+    Graph<T, W> buildGraph();
+
+    /**
+     * @brief Builds a directed graph from everything queued and empties the builder.
+     *
+     * @param trackInEdges Whether the result maintains its in-edge index.
+     */
+    Digraph<T, W> buildDigraph(bool trackInEdges = false);
+
+    /**
+     * @brief Packs everything queued into CSR form and empties the builder.
+     *
+     * Vertices get dense ids in an unspecified but complete order; parallel edges are kept,
+     * as with the file loaders.
+     *
+     * @param directed False to store every edge in both directions.
+     * @param ids When not null, receives the vertex of every id.
+     * @throw std::length_error If there are more vertices than CsrGraph::VertexId can number.
+     */
+    CsrGraph<W> buildCsr(bool directed, std::vector<T> *ids = nullptr);
+};
+
+template<class T, class W>
+ConcurrentGraphBuilder<T, W>::ConcurrentGraphBuilder(unsigned threads) : serial(nextSerial()) {
+    this->threads = std::max(1u, threads != 0 ? threads : std::thread::hardware_concurrency());
+
+    partCount = 16;
+    while (partCount < size_t(4) * this->threads) partCount *= 2;
+}
+
+template<class T, class W>
+uint64_t ConcurrentGraphBuilder<T, W>::nextSerial() {
+    static std::atomic<uint64_t> last{0};
+    return ++last;
+}
+
+template<class T, class W>
+typename ConcurrentGraphBuilder<T, W>::Buffer &ConcurrentGraphBuilder<T, W>::local() {
+    // a single entry: a thread usually feeds one builder at a time
+    thread_local uint64_t cachedSerial = 0;
+    thread_local Buffer *cached = nullptr;
+    if (cachedSerial == serial) return *cached;
+
+    std::lock_guard<std::mutex> guard(lock);
+    const std::thread::id self = std::this_thread::get_id();
+    auto it = std::find_if(buffers.begin(), buffers.end(), [&](const auto &buffer) { return buffer->owner == self; });
+    if (it == buffers.end()) {
+        buffers.push_back(std::make_unique<Buffer>());
+        buffers.back()->owner = self;
+        buffers.back()->edges.reserve(share);
+        it = buffers.end() - 1;
+    }
+    cachedSerial = serial;
+    cached = it->get();
+    return *cached;
+}
+
+template<class T, class W>
+size_t ConcurrentGraphBuilder<T, W>::partOf(const T &vertex) const {
+    uint64_t x = std::hash<T>()(vertex);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<size_t>(x ^ (x >> 31)) & (partCount - 1);
+}
+
+template<class T, class W>
+template<class Task>
+void ConcurrentGraphBuilder<T, W>::forEach(size_t count, Task task) {
+    ParallelOptions options;
+    options.threads = threads;
+    options.grain = 1;
+    ThreadPool::global().parallelFor(0, count, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) task(i);
+    }, options);
+}
+
+template<class T, class W>
+void ConcurrentGraphBuilder<T, W>::reserve(size_t edges) {
+    share = edges / threads + 1;
+    share += share / 4;
+    for (auto &buffer : buffers) buffer->edges.reserve(share);
+}
+
+template<class T, class W>
+ConcurrentGraphBuilder<T, W> &ConcurrentGraphBuilder<T, W>::addVertex(const T &vertex) {
+    local().vertices.push_back(vertex);
+    return *this;
+}
+
+template<class T, class W>
+ConcurrentGraphBuilder<T, W> &ConcurrentGraphBuilder<T, W>::addEdge(const T &from, const T &to, W weight) {
+    Buffer &buffer = local();
+    buffer.edges.emplace_back(from, to, weight);
+    buffer.queued.store(buffer.edges.size(), std::memory_order_relaxed);
+    return *this;
+}
+
+template<class T, class W>
+size_t ConcurrentGraphBuilder<T, W>::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    size_t total = 0;
+    for (const auto &buffer : buffers) total += buffer->queued.load(std::memory_order_relaxed);
+    return total;
+}
+
+template<class T, class W>
+void ConcurrentGraphBuilder<T, W>::clear() {
+    buffers.clear();
+    serial = nextSerial();
+}
+
+template<class T, class W>
+template<class G>
+void ConcurrentGraphBuilder<T, W>::fill(G &graph) {
+    size_t total = 0;
+    for (const auto &buffer : buffers) total += buffer->edges.size();
+
+    std::vector<std::tuple<T, T, W>> all;
+    all.reserve(total);
+    for (auto &buffer : buffers) {
+        std::move(buffer->edges.begin(), buffer->edges.end(), std::back_inserter(all));
+        buffer->edges = std::vector<std::tuple<T, T, W>>();
+    }
+
+    graph.bulkInsert(all);
+    for (const auto &buffer : buffers)
+        for (const T &vertex : buffer->vertices) graph.addVertex(vertex);
+    clear();
+}
+
+template<class T, class W>
+Graph<T, W> ConcurrentGraphBuilder<T, W>::buildGraph() {
+    Graph<T, W> graph;
+    fill(graph);
+    return graph;
+}
+
+template<class T, class W>
+Digraph<T, W> ConcurrentGraphBuilder<T, W>::buildDigraph(bool trackInEdges) {
+    Digraph<T, W> graph(trackInEdges);
+    fill(graph);
+    return graph;
+}
+
+template<class T, class W>
+CsrGraph<W> ConcurrentGraphBuilder<T, W>::buildCsr(bool directed, std::vector<T> *ids) {
+    using VertexId = typename CsrGraph<W>::VertexId;
+    using Arc = typename CsrGraph<W>::Arc;
+
+    const size_t producers = buffers.size();
+
+    // 1. every buffer splits the ends of its edges and its isolated vertices into parts by hash
+    std::vector<std::vector<std::vector<T>>> keys(producers, std::vector<std::vector<T>>(partCount));
+    forEach(producers, [&](size_t b) {
+        for (const auto &[from, to, weight] : buffers[b]->edges) {
+            keys[b][partOf(from)].push_back(from);
+            keys[b][partOf(to)].push_back(to);
+        }
+        for (const T &vertex : buffers[b]->vertices) keys[b][partOf(vertex)].push_back(vertex);
+    });
+
+    // 2. every part numbers its vertices; a vertex lives in exactly one part, so no lock is needed
+    std::vector<std::unordered_map<T, VertexId>> local(partCount);
+    std::vector<std::vector<T>> owned(partCount);
+    forEach(partCount, [&](size_t p) {
+        for (size_t b = 0; b < producers; b++) {
+            for (const T &vertex : keys[b][p])
+                if (local[p].try_emplace(vertex, (VertexId) owned[p].size()).second) owned[p].push_back(vertex);
+            keys[b][p] = std::vector<T>();
+        }
+    });
+
+    std::vector<size_t> base(partCount + 1, 0);
+    for (size_t p = 0; p < partCount; p++) base[p + 1] = base[p] + owned[p].size();
+    if (base[partCount] > std::numeric_limits<VertexId>::max())
+        throw std::length_error("ConcurrentGraphBuilder: too many vertices for a CsrGraph");
+
+    // 3. every buffer translates its own edges into one chunk of arcs
+    std::vector<std::vector<Arc>> chunks(producers);
+    forEach(producers, [&](size_t b) {
+        chunks[b].reserve(buffers[b]->edges.size());
+        for (const auto &[from, to, weight] : buffers[b]->edges) {
+            const size_t p = partOf(from), r = partOf(to);
+            chunks[b].push_back({(VertexId) (base[p] + local[p].find(from)->second),
+                                 (VertexId) (base[r] + local[r].find(to)->second), weight});
+        }
+    });
+
+    if (ids != nullptr) {
+        ids->clear();
+        ids->reserve(base[partCount]);
+        for (auto &vertices : owned) std::move(vertices.begin(), vertices.end(), std::back_inserter(*ids));
+    }
+
+    clear();
+    return CsrGraph<W>::fromArcs(base[partCount], chunks, directed);
+}
+
+#endif //GRAPHALGORITHM_CONCURRENTGRAPHBUILDER_HPP
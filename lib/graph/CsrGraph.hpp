@@ -0,0 +1,289 @@
+#ifndef GRAPHALGORITHM_CSRGRAPH_HPP
+#define GRAPHALGORITHM_CSRGRAPH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "MemoryUsage.hpp"
+
+/**
+ * A read-only graph stored in compressed sparse row (CSR) layout.
+ *
+ * Vertices are dense ids in [0, getVertexCount()). The out-arcs of vertex v are the
+ * slots [offsets[v], offsets[v + 1]) of the targets/weights arrays, so a traversal
+ * walks contiguous memory instead of hash buckets.
+ *
+ * @tparam W weight type stored on each arc
+ */
+template<class W = double>
+class CsrGraph {
+public:
+    using VertexId = uint32_t;
+    using EdgeId = uint64_t;
+
+    /**
+     * A single arc as produced by loaders and builders before it is packed into the CSR arrays.
+     */
+    struct Arc {
+        VertexId from;
+        VertexId to;
+        W weight;
+    };
+
+    /**
+     * A lightweight [begin, end) view over a slice of one of the CSR arrays.
+     */
+    template<class V>
+    class Range {
+        const V *first;
+        const V *last;
+
+    public:
+        Range(const V *first, const V *last) : first(first), last(last) {}
+
+        const V *begin() const { return first; }
+        const V *end() const { return last; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+        const V &operator[](size_t i) const { return first[i]; }
+    };
+
+private:
+    bool directed = true;
+    std::vector<EdgeId> offsets{0};
+    std::vector<VertexId> targets;
+    std::vector<W> weights;
+
+    static CsrGraph<W> pack(size_t vertexCount, const std::vector<const std::vector<Arc> *> &chunks, bool directed,
+                            std::vector<EdgeId> *origins);
+
+public:
+    CsrGraph() = default;
+
+    /**
+     * @brief Packs a list of arcs into CSR form with a counting sort by source vertex.
+     *
+     * Arcs keep their input order inside each adjacency list. For an undirected graph every
+     * arc (u, v) is stored in both directions; self-loops are stored once.
+     *
+     * @param vertexCount Number of vertices; every arc endpoint must be smaller than this.
+     * @param chunks The arcs, possibly split in several chunks (e.g. one per parser thread).
+     * @param directed False to mirror every arc.
+     * @param origins When not null, receives for every edge id the index of the input arc it came
+     *                from (arcs numbered across chunks in order). Pass it to EdgeColumns::gather
+     *                to move per-arc attributes to edge ids.
+     * @return The packed graph.
+     */
+    static CsrGraph<W> fromArcs(size_t vertexCount, const std::vector<std::vector<Arc>> &chunks, bool directed,
+                                std::vector<EdgeId> *origins = nullptr);
+
+    /**
+     * @brief Same as above for a single chunk of arcs.
+     */
+    static CsrGraph<W> fromArcs(size_t vertexCount, const std::vector<Arc> &arcs, bool directed,
+                                std::vector<EdgeId> *origins = nullptr);
+
+    /**
+     * @return The number of vertices.
+     */
+    size_t getVertexCount() const;
+
+    /**
+     * @return The number of stored arcs. An undirected edge counts twice unless it is a self-loop.
+     */
+    size_t getEdgeCount() const;
+
+    /**
+     * @return True if arcs were not mirrored while building.
+     */
+    bool isDirected() const;
+
+    /**
+     * @return The out-degree of the vertex.
+     */
+    size_t getDegree(VertexId v) const;
+
+    /**
+     * @return The first arc id of the vertex.
+     */
+    EdgeId edgeBegin(VertexId v) const;
+
+    /**
+     * @return One past the last arc id of the vertex.
+     */
+    EdgeId edgeEnd(VertexId v) const;
+
+    /**
+     * @return The head (destination) of the arc.
+     */
+    VertexId getTarget(EdgeId e) const;
+
+    /**
+     * @return The weight of the arc.
+     */
+    W getWeight(EdgeId e) const;
+
+    /**
+     * @return A read-only view of the vertices adjacent to v.
+     */
+    Range<VertexId> getAdjacent(VertexId v) const;
+
+    /**
+     * @return A read-only view of the weights of the arcs leaving v, parallel to getAdjacent(v).
+     */
+    Range<W> getAdjacentWeights(VertexId v) const;
+
+    /**
+     * @return The raw offsets array (getVertexCount() + 1 entries).
+     */
+    const std::vector<EdgeId> &getOffsets() const;
+
+    /**
+     * @return The raw targets array (getEdgeCount() entries).
+     */
+    const std::vector<VertexId> &getTargets() const;
+
+    /**
+     * @return The raw weights array (getEdgeCount() entries).
+     */
+    const std::vector<W> &getWeights() const;
+
+    /**
+     * @return The bytes of the offset, target and weight arrays.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class W>
+CsrGraph<W> CsrGraph<W>::pack(size_t vertexCount, const std::vector<const std::vector<Arc> *> &chunks, bool directed,
+                              std::vector<EdgeId> *origins) {
+    CsrGraph<W> csr;
+    csr.directed = directed;
+    csr.offsets.assign(vertexCount + 1, 0);
+
+    for (const auto *chunk : chunks) {
+        for (const auto &arc : *chunk) {
+            csr.offsets[arc.from + 1]++;
+            if (!directed && arc.from != arc.to) csr.offsets[arc.to + 1]++;
+        }
+    }
+
+    for (size_t v = 0; v < vertexCount; v++)
+        csr.offsets[v + 1] += csr.offsets[v];
+
+    csr.targets.resize(csr.offsets[vertexCount]);
+    csr.weights.resize(csr.offsets[vertexCount]);
+    if (origins != nullptr) origins->resize(csr.offsets[vertexCount]);
+
+    std::vector<EdgeId> cursor(csr.offsets.begin(), csr.offsets.end() - 1);
+    EdgeId input = 0;
+    for (const auto *chunk : chunks) {
+        for (const auto &arc : *chunk) {
+            EdgeId slot = cursor[arc.from]++;
+            csr.targets[slot] = arc.to;
+            csr.weights[slot] = arc.weight;
+            if (origins != nullptr) (*origins)[slot] = input;
+
+            if (!directed && arc.from != arc.to) {
+                slot = cursor[arc.to]++;
+                csr.targets[slot] = arc.from;
+                csr.weights[slot] = arc.weight;
+                if (origins != nullptr) (*origins)[slot] = input;
+            }
+            input++;
+        }
+    }
+
+    return csr;
+}
+
+template<class W>
+CsrGraph<W> CsrGraph<W>::fromArcs(size_t vertexCount, const std::vector<std::vector<Arc>> &chunks, bool directed,
+                                  std::vector<EdgeId> *origins) {
+    std::vector<const std::vector<Arc> *> views;
+    views.reserve(chunks.size());
+    for (const auto &chunk : chunks) views.push_back(&chunk);
+    return pack(vertexCount, views, directed, origins);
+}
+
+template<class W>
+CsrGraph<W> CsrGraph<W>::fromArcs(size_t vertexCount, const std::vector<Arc> &arcs, bool directed,
+                                  std::vector<EdgeId> *origins) {
+    return pack(vertexCount, {&arcs}, directed, origins);
+}
+
+template<class W>
+size_t CsrGraph<W>::getVertexCount() const {
+    return offsets.size() - 1;
+}
+
+template<class W>
+size_t CsrGraph<W>::getEdgeCount() const {
+    return targets.size();
+}
+
+template<class W>
+bool CsrGraph<W>::isDirected() const {
+    return directed;
+}
+
+template<class W>
+size_t CsrGraph<W>::getDegree(VertexId v) const {
+    return offsets[v + 1] - offsets[v];
+}
+
+template<class W>
+typename CsrGraph<W>::EdgeId CsrGraph<W>::edgeBegin(VertexId v) const {
+    return offsets[v];
+}
+
+template<class W>
+typename CsrGraph<W>::EdgeId CsrGraph<W>::edgeEnd(VertexId v) const {
+    return offsets[v + 1];
+}
+
+template<class W>
+typename CsrGraph<W>::VertexId CsrGraph<W>::getTarget(EdgeId e) const {
+    return targets[e];
+}
+
+template<class W>
+W CsrGraph<W>::getWeight(EdgeId e) const {
+    return weights[e];
+}
+
+template<class W>
+typename CsrGraph<W>::template Range<typename CsrGraph<W>::VertexId> CsrGraph<W>::getAdjacent(VertexId v) const {
+    return Range<VertexId>(targets.data() + offsets[v], targets.data() + offsets[v + 1]);
+}
+
+template<class W>
+typename CsrGraph<W>::template Range<W> CsrGraph<W>::getAdjacentWeights(VertexId v) const {
+    return Range<W>(weights.data() + offsets[v], weights.data() + offsets[v + 1]);
+}
+
+template<class W>
+const std::vector<typename CsrGraph<W>::EdgeId> &CsrGraph<W>::getOffsets() const {
+    return offsets;
+}
+
+template<class W>
+const std::vector<typename CsrGraph<W>::VertexId> &CsrGraph<W>::getTargets() const {
+    return targets;
+}
+
+template<class W>
+const std::vector<W> &CsrGraph<W>::getWeights() const {
+    return weights;
+}
+
+template<class W>
+MemoryUsage CsrGraph<W>::memoryUsage() const {
+    MemoryUsage usage = MemoryUsage::of(offsets);
+    usage += MemoryUsage::of(targets);
+    usage += MemoryUsage::of(weights);
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_CSRGRAPH_HPP
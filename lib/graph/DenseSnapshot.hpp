@@ -0,0 +1,175 @@
+#ifndef GRAPHALGORITHM_DENSESNAPSHOT_HPP
+#define GRAPHALGORITHM_DENSESNAPSHOT_HPP
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "CsrGraph.hpp"
+#include "MemoryUsage.hpp"
+
+/**
+ * A copy of a Graph or Digraph with the vertices numbered densely and the edges in a CsrGraph,
+ * for the algorithms that run on flat arrays indexed by vertex id.
+ *
+ * Vertex ids follow getVertices(), i.e. the hash order of the graph, and the arcs of a vertex
+ * its adjacency order. An undirected Graph already lists every edge from both ends, so the
+ * CsrGraph is packed as directed either way.
+ *
+ * The copy is taken by the first refresh and kept until changeGraph or build: it does not
+ * follow later edits of the graph. An algorithm owning a snapshot takes it lazily on its first
+ * query, and its own changeGraph (which calls the snapshot's) must be called after editing the
+ * graph, or queries keep running on the old copy. This holds for DagAlgorithm, FlowAlgorithm,
+ * MinCostFlowAlgorithm, MatchingAlgorithm, PageRankAlgorithm and CentralityAlgorithm.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges
+ * @tparam G graph type
+ */
+template<class T, class W, class G>
+class DenseSnapshot {
+public:
+    using VertexId = typename CsrGraph<W>::VertexId;
+    using EdgeId = typename CsrGraph<W>::EdgeId;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+private:
+    G *graph;
+
+    std::vector<T> vertices;
+    std::unordered_map<T, VertexId> index;
+    CsrGraph<W> csr;
+    bool directed = true;
+    bool built = false;
+
+public:
+    explicit DenseSnapshot(G *graph);
+
+    /**
+     * @brief Points to another graph (or the same one, edited); the next refresh copies it again.
+     */
+    void changeGraph(G *graf);
+
+    /**
+     * @brief Copies the graph now, whether or not the snapshot is up to date.
+     * @throw std::length_error If the graph has NO_VERTEX vertices or more.
+     */
+    void build();
+
+    /**
+     * @brief Copies the graph if it was never copied or changeGraph was called since.
+     * @return True if it did, i.e. anything derived from the previous copy is stale.
+     */
+    bool refresh();
+
+    /**
+     * @return The number of vertices of the copy.
+     */
+    size_t size() const;
+
+    /**
+     * @return True if the copied graph was directed; the CsrGraph is packed as directed either way.
+     */
+    bool isDirected() const;
+
+    /**
+     * @return The edges of the copy, between dense ids.
+     */
+    const CsrGraph<W> &getCsr() const;
+
+    /**
+     * @return Every vertex, indexed by its id.
+     */
+    const std::vector<T> &getVertices() const;
+
+    const T &getVertex(VertexId id) const;
+
+    /**
+     * @return The id of the vertex, NO_VERTEX if it is not in the copy.
+     */
+    VertexId find(const T &vertex) const;
+
+    /**
+     * @return The bytes of the vertex table, the id map and the CsrGraph.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class T, class W, class G>
+DenseSnapshot<T, W, G>::DenseSnapshot(G *graph) : graph(graph) {}
+
+template<class T, class W, class G>
+void DenseSnapshot<T, W, G>::changeGraph(G *graf) {
+    this->graph = graf;
+    built = false;
+}
+
+template<class T, class W, class G>
+void DenseSnapshot<T, W, G>::build() {
+    vertices.clear();
+    index.clear();
+    for (const T &vertex : graph->getVertices()) vertices.push_back(vertex);
+    if (vertices.size() >= NO_VERTEX) throw std::length_error("DenseSnapshot: too many vertices");
+
+    index.reserve(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) index.emplace(vertices[i], (VertexId) i);
+
+    std::vector<typename CsrGraph<W>::Arc> arcs;
+    for (VertexId u = 0; u < vertices.size(); u++)
+        for (const auto &edge : (*graph)[vertices[u]])
+            arcs.push_back({u, index.find(edge.getTo())->second, edge.getWeight()});
+    csr = CsrGraph<W>::fromArcs(vertices.size(), arcs, true);
+    directed = graph->isDirected();
+    built = true;
+}
+
+template<class T, class W, class G>
+bool DenseSnapshot<T, W, G>::refresh() {
+    if (built) return false;
+    build();
+    return true;
+}
+
+template<class T, class W, class G>
+size_t DenseSnapshot<T, W, G>::size() const {
+    return vertices.size();
+}
+
+template<class T, class W, class G>
+bool DenseSnapshot<T, W, G>::isDirected() const {
+    return directed;
+}
+
+template<class T, class W, class G>
+const CsrGraph<W> &DenseSnapshot<T, W, G>::getCsr() const {
+    return csr;
+}
+
+template<class T, class W, class G>
+const std::vector<T> &DenseSnapshot<T, W, G>::getVertices() const {
+    return vertices;
+}
+
+template<class T, class W, class G>
+const T &DenseSnapshot<T, W, G>::getVertex(VertexId id) const {
+    return vertices[id];
+}
+
+template<class T, class W, class G>
+typename DenseSnapshot<T, W, G>::VertexId DenseSnapshot<T, W, G>::find(const T &vertex) const {
+    auto it = index.find(vertex);
+    return it != index.end() ? it->second : NO_VERTEX;
+}
+
+template<class T, class W, class G>
+MemoryUsage DenseSnapshot<T, W, G>::memoryUsage() const {
+    MemoryUsage usage = MemoryUsage::of(vertices);
+    usage += MemoryUsage::of(index);
+    usage += csr.memoryUsage();
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_DENSESNAPSHOT_HPP
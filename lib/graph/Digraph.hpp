@@ -7,17 +7,94 @@
 
 #include "Graph.hpp"
 #include <ostream>
+#include <stdexcept>
+#include <type_traits>
 
-template <class T>
-class Digraph : public Graph<T> {
+template<class T, class W = double, class Allocator = std::allocator<T>>
+class Digraph : public Graph<T, W, Allocator> {
+    using EdgeSet = typename Graph<T, W, Allocator>::EdgeSet;
+    using AdjacencyMap = typename Graph<T, W, Allocator>::AdjacencyMap;
+
+    /**
+     * Incoming edges of every vertex (kept in their original from -> to orientation),
+     * maintained only while trackInEdges is true. Shares the allocator of the graph.
+     */
+    AdjacencyMap reverse;
+    bool trackInEdges;
+
+protected:
+    using IdArc = typename Graph<T, W, Allocator>::IdArc;
+
+    void edgeTo(const T &from, const T &to, W weight) override;
+    void linkSorted(const std::vector<T> &ids, const std::vector<IdArc> &arcs) override;
 
 public:
+    Digraph();
+
+    /**
+     * @param allocator Allocates the vertices and edges, e.g. PmrDigraph<int> graph(&pool).
+     */
+    explicit Digraph(const Allocator &allocator);
+
+    /**
+     * @param trackInEdges Whether to maintain the in-edge index, see setInEdgeIndex.
+     *
+     * @note Only a bool selects this overload, so a memory_resource pointer goes to the allocator
+     *       instead of silently converting to the flag.
+     */
+    template<class Flag, std::enable_if_t<std::is_same_v<Flag, bool>, int> = 0>
+    explicit Digraph(Flag trackInEdges, const Allocator &allocator = Allocator());
+
+    /**
+     * @brief Removes a vertex and every edge entering or leaving it.
+     *
+     * @note O(in + out degree) with the in-edge index, O(V) without it.
+     */
     bool removeVertex(const T &data) override;
 
-    void addEdge(const T &from, const T &to, int weight) override;
+    void addEdge(const T &from, const T &to, W weight) override;
+
+    bool isDirected() const override;
+
+    /**
+     * @brief Turns the in-edge index on (built in O(V + E)) or off (its memory is released).
+     *
+     * The index makes removeVertex, inDegree and getIncoming cost O(in + out degree)
+     * at the price of storing every edge a second time.
+     */
+    void setInEdgeIndex(bool enabled);
+
+    /**
+     * @return True if the in-edge index is maintained.
+     */
+    bool hasInEdgeIndex() const;
+
+    /**
+     * @brief Find all edges pointing to the given vertex, for backward traversals.
+     *
+     * @param data The head of the edges.
+     * @return Read-only set of edges (from, data); empty if the vertex has none.
+     * @throw std::logic_error If the in-edge index is disabled.
+     */
+    const EdgeSet &getIncoming(const T &data) const;
+
+    /**
+     * @return The number of edges pointing to the vertex. O(1) with the in-edge index, O(V) without it.
+     */
+    size_t inDegree(const T &data) const;
+
+    /**
+     * @return The number of edges leaving the vertex.
+     */
+    size_t outDegree(const T &data) const;
+
+    /**
+     * @brief Same as Graph::memoryUsage, plus the in-edge index when it is maintained.
+     */
+    MemoryUsage memoryUsage() const override;
 
 public:
-    friend std::ostream &operator<<(std::ostream &os, const Digraph<T> &digraph) {
+    friend std::ostream &operator<<(std::ostream &os, const Digraph<T, W, Allocator> &digraph) {
         auto &graph = digraph.graph;
         for (const auto &[key, value]: graph) {
             if (!value.empty()) os << key << " -> ";
@@ -33,30 +110,134 @@ public:
     }
 };
 
-template<class T>
-bool Digraph<T>::removeVertex(const T &data) {
+template<class T, class W, class Allocator>
+Digraph<T, W, Allocator>::Digraph() : Digraph(false) {}
+
+template<class T, class W, class Allocator>
+Digraph<T, W, Allocator>::Digraph(const Allocator &allocator) : Digraph(false, allocator) {}
+
+template<class T, class W, class Allocator>
+template<class Flag, std::enable_if_t<std::is_same_v<Flag, bool>, int>>
+Digraph<T, W, Allocator>::Digraph(Flag trackInEdges, const Allocator &allocator)
+    : Graph<T, W, Allocator>(allocator), reverse(typename AdjacencyMap::allocator_type(allocator)),
+      trackInEdges(trackInEdges) {}
+
+template<class T, class W, class Allocator>
+void Digraph<T, W, Allocator>::edgeTo(const T &from, const T &to, W weight) {
+    Graph<T, W, Allocator>::edgeTo(from, to, weight);
+    if (trackInEdges) reverse[to].insert(Edge<T, W>(from, to, weight));
+}
+
+template<class T, class W, class Allocator>
+void Digraph<T, W, Allocator>::linkSorted(const std::vector<T> &ids, const std::vector<IdArc> &arcs) {
+    Graph<T, W, Allocator>::linkSorted(ids, arcs);
+    if (!trackInEdges) return;
+
+    for (const auto &arc : arcs)
+        reverse[ids[arc.to]].insert(Edge<T, W>(ids[arc.from], ids[arc.to], arc.weight));
+}
+
+template<class T, class W, class Allocator>
+bool Digraph<T, W, Allocator>::removeVertex(const T &data) {
     auto &graph = this->graph;
-    this->vertices.erase(data);
 
-    if (graph.find(data) != graph.end()) {
-        for (auto &[from, edges] : graph) {
-            if (from == data) continue;
-            auto ed = Edge<T>(from, data, 0);
-            graph[from].erase(ed);
-            this->edges.erase(ed);
+    auto it = graph.find(data);
+    if (it == graph.end()) return false;
+
+    if (trackInEdges) {
+        auto in = reverse.find(data);
+        if (in != reverse.end()) {
+            for (const auto &edge : in->second) {
+                if (edge.getFrom() == data) continue;
+                this->edgeCount -= graph.find(edge.getFrom())->second.erase(edge);
+            }
+            reverse.erase(in);
         }
 
-        graph.erase(data);
-        return true;
+        for (const auto &edge : it->second) {
+            if (edge.getTo() == data) continue;
+            auto out = reverse.find(edge.getTo());
+            if (out != reverse.end()) out->second.erase(edge);
+        }
+    } else {
+        for (auto &[from, adjacent] : graph) {
+            if (from == data) continue;
+            this->edgeCount -= adjacent.erase(Edge<T, W>(from, data, 0));
+        }
     }
-    return false;
+
+    this->edgeCount -= it->second.size();
+    graph.erase(it);
+    return true;
 }
 
-template<class T>
-void Digraph<T>::addEdge(const T &from, const T &to, int weight) {
+template<class T, class W, class Allocator>
+void Digraph<T, W, Allocator>::addEdge(const T &from, const T &to, W weight) {
     this->edgeTo(from, to, weight);
 }
 
+template<class T, class W, class Allocator>
+bool Digraph<T, W, Allocator>::isDirected() const {
+    return true;
+}
+
+template<class T, class W, class Allocator>
+void Digraph<T, W, Allocator>::setInEdgeIndex(bool enabled) {
+    if (enabled == trackInEdges) return;
+    trackInEdges = enabled;
+    // clear() would keep the bucket array; swapping with an empty map gives it back
+    AdjacencyMap(reverse.get_allocator()).swap(reverse);
+    if (!enabled) return;
+
+    for (const auto &[from, adjacent] : this->graph)
+        for (const auto &edge : adjacent)
+            reverse[edge.getTo()].insert(edge);
+}
+
+template<class T, class W, class Allocator>
+MemoryUsage Digraph<T, W, Allocator>::memoryUsage() const {
+    MemoryUsage usage = Graph<T, W, Allocator>::memoryUsage();
+    usage += MemoryUsage::of(reverse);
+    for (const auto &entry : reverse) usage += entry.second.memoryUsage();
+    return usage;
+}
+
+template<class T, class W, class Allocator>
+bool Digraph<T, W, Allocator>::hasInEdgeIndex() const {
+    return trackInEdges;
+}
+
+template<class T, class W, class Allocator>
+const typename Digraph<T, W, Allocator>::EdgeSet &Digraph<T, W, Allocator>::getIncoming(const T &data) const {
+    if (!trackInEdges) throw std::logic_error("Digraph::getIncoming requires the in-edge index");
+
+    static const EdgeSet emptySet;
+    auto it = reverse.find(data);
+    return it != reverse.end() ? it->second : emptySet;
+}
+
+template<class T, class W, class Allocator>
+size_t Digraph<T, W, Allocator>::inDegree(const T &data) const {
+    if (trackInEdges) return getIncoming(data).size();
+
+    size_t degree = 0;
+    for (const auto &[from, adjacent] : this->graph)
+        degree += adjacent.count(Edge<T, W>(from, data, 0));
+    return degree;
+}
+
+template<class T, class W, class Allocator>
+size_t Digraph<T, W, Allocator>::outDegree(const T &data) const {
+    auto it = this->graph.find(data);
+    return it != this->graph.end() ? it->second.size() : 0;
+}
+
+/**
+ * A Digraph living in a std::pmr::memory_resource, see PmrGraph.
+ */
+template<class T, class W = double>
+using PmrDigraph = Digraph<T, W, std::pmr::polymorphic_allocator<T>>;
+
 #endif //GRAPHALGORITHM_DIGRAPH_HPP
 
 
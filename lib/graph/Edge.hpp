@@ -1,88 +1,99 @@
 #ifndef GRAPHALGORITHM_EDGE_HPP
 #define GRAPHALGORITHM_EDGE_HPP
 
+#include <cstdint>
 #include <functional>
 #include <string>
 
-template <class T>
+/**
+ * A connection between two vertices.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type, e.g. uint16_t, uint32_t, float or double
+ */
+template <class T, class W = double>
 class Edge {
     T from;
     T to;
-    double weight{};
+    W weight{};
 
 public:
     Edge() = default;
-    Edge(const T &from, const T &to, double weight = 1);
+    Edge(const T &from, const T &to, W weight = 1);
 
-    T getFrom() const;
-    T getTo() const;
-    double getWeight() const;
+    const T &getFrom() const;
+    const T &getTo() const;
+    W getWeight() const;
 
-    bool operator<(const Edge<T>& rhs) const;
-    bool operator>(const Edge<T>& rhs) const;
-    bool operator<=(const Edge<T>& rhs) const;
-    bool operator>=(const Edge<T>& rhs) const;
-    bool operator==(const Edge<T>& rhs) const;
-    bool operator!=(const Edge<T>& rhs) const;
+    bool operator<(const Edge<T, W>& rhs) const;
+    bool operator>(const Edge<T, W>& rhs) const;
+    bool operator<=(const Edge<T, W>& rhs) const;
+    bool operator>=(const Edge<T, W>& rhs) const;
+    bool operator==(const Edge<T, W>& rhs) const;
+    bool operator!=(const Edge<T, W>& rhs) const;
 
 };
 
 namespace std {
-    template <class T>
-    struct hash<Edge<T>> {
-    size_t operator()(const Edge<T>& edge) const {
-        size_t hashFrom = std::hash<T>()(edge.getFrom());
-        size_t hashTo = std::hash<T>()(edge.getTo());
-        return hashFrom ^ hashTo;
+    template <class T, class W>
+    struct hash<Edge<T, W>> {
+    size_t operator()(const Edge<T, W>& edge) const {
+        // order dependent combination: (u, v) and (v, u) differ and self-loops do not collapse to 0
+        uint64_t hashFrom = std::hash<T>()(edge.getFrom());
+        uint64_t hashTo = std::hash<T>()(edge.getTo());
+        uint64_t x = hashFrom * 0x9e3779b97f4a7c15ULL + hashTo;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<size_t>(x ^ (x >> 31));
     }
 };
 }  // namespace std
 
-template <class T>
-Edge<T>::Edge(const T &from, const T &to, double weight) : from(from), to(to), weight(weight) {}
+template <class T, class W>
+Edge<T, W>::Edge(const T &from, const T &to, W weight) : from(from), to(to), weight(weight) {}
 
-template <class T>
-T Edge<T>::getFrom() const {
+template <class T, class W>
+const T &Edge<T, W>::getFrom() const {
     return from;
 }
 
-template <class T>
-T Edge<T>::getTo() const {
+template <class T, class W>
+const T &Edge<T, W>::getTo() const {
     return to;
 }
 
-template <class T>
-double Edge<T>::getWeight() const {
+template <class T, class W>
+W Edge<T, W>::getWeight() const {
     return weight;
 }
 
-template <class T>
-bool Edge<T>::operator<(const Edge<T>& rhs) const {
+template <class T, class W>
+bool Edge<T, W>::operator<(const Edge<T, W>& rhs) const {
     return weight < rhs.weight;
 }
 
-template <class T>
-bool Edge<T>::operator>(const Edge<T>& rhs) const {
+template <class T, class W>
+bool Edge<T, W>::operator>(const Edge<T, W>& rhs) const {
     return weight > rhs.weight;
 }
 
-template <class T>
-bool Edge<T>::operator<=(const Edge<T>& rhs) const {
+template <class T, class W>
+bool Edge<T, W>::operator<=(const Edge<T, W>& rhs) const {
     return *this < rhs || *this == rhs;
 }
 
-template <class T>
-bool Edge<T>::operator>=(const Edge<T>& rhs) const {
+template <class T, class W>
+bool Edge<T, W>::operator>=(const Edge<T, W>& rhs) const {
     return *this > rhs || *this == rhs;
 }
 
-template <class T>
-bool Edge<T>::operator==(const Edge<T>& rhs) const {
+template <class T, class W>
+bool Edge<T, W>::operator==(const Edge<T, W>& rhs) const {
     return from == rhs.from && to == rhs.to;
 }
 
-template <class T>
-bool Edge<T>::operator!=(const Edge<T>& rhs) const {
+template <class T, class W>
+bool Edge<T, W>::operator!=(const Edge<T, W>& rhs) const {
     return !(rhs == *this);
 }
 
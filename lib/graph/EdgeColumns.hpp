@@ -0,0 +1,158 @@
+#ifndef GRAPHALGORITHM_EDGECOLUMNS_HPP
+#define GRAPHALGORITHM_EDGECOLUMNS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Edge attributes stored as a struct of arrays: one contiguous vector per attribute, all
+ * indexed by the same edge id.
+ *
+ * A kernel that only needs one attribute (e.g. distance) streams just that vector instead of
+ * dragging every attribute of every edge through the cache. Columns are addressed by index,
+ * typically through an enum:
+ *
+ * @code
+ * enum Road { TRAVEL_TIME, DISTANCE, CAPACITY, COST };
+ * EdgeColumns<float, float, uint32_t, double> roads(csr.getEdgeCount());
+ * roads.column<DISTANCE>()[e] = 12.5f;
+ * algorithm.dijkstra(source, roads.column<TRAVEL_TIME>());
+ * @endcode
+ *
+ * @tparam Columns value type of every column
+ */
+template<class... Columns>
+class EdgeColumns {
+    std::tuple<std::vector<Columns>...> columns;
+
+    template<size_t... I>
+    void resizeAll(size_t count, std::index_sequence<I...>);
+
+    template<size_t... I>
+    void pushAll(const std::tuple<Columns...> &values, std::index_sequence<I...>);
+
+    template<size_t... I>
+    EdgeColumns<Columns...> gatherAll(const std::vector<uint64_t> &origins, std::index_sequence<I...>) const;
+
+public:
+    /**
+     * Number of attributes per edge.
+     */
+    static constexpr size_t COLUMN_COUNT = sizeof...(Columns);
+
+    /**
+     * Type of the I-th column.
+     */
+    template<size_t I>
+    using ColumnType = std::vector<std::tuple_element_t<I, std::tuple<Columns...>>>;
+
+    EdgeColumns() = default;
+
+    /**
+     * @brief Creates the columns with count value-initialized entries each.
+     */
+    explicit EdgeColumns(size_t count);
+
+    /**
+     * @return The number of edges described.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Resizes every column to count entries.
+     */
+    void resize(size_t count);
+
+    /**
+     * @brief Appends one edge with all of its attributes.
+     */
+    void push_back(const Columns &... values);
+
+    /**
+     * @return A read/write reference to the I-th column.
+     */
+    template<size_t I>
+    ColumnType<I> &column();
+
+    /**
+     * @return A read-only reference to the I-th column.
+     */
+    template<size_t I>
+    const ColumnType<I> &column() const;
+
+    /**
+     * @brief Reorders the columns so that entry e of the result is entry origins[e] of this object.
+     *
+     * Used with the origins reported by CsrGraph::fromArcs to move attributes given in input
+     * order to CSR edge ids; a mirrored undirected arc simply repeats its origin.
+     */
+    EdgeColumns<Columns...> gather(const std::vector<uint64_t> &origins) const;
+};
+
+template<class... Columns>
+EdgeColumns<Columns...>::EdgeColumns(size_t count) {
+    resize(count);
+}
+
+template<class... Columns>
+size_t EdgeColumns<Columns...>::size() const {
+    if constexpr (sizeof...(Columns) == 0) return 0;
+    else return std::get<0>(columns).size();
+}
+
+template<class... Columns>
+void EdgeColumns<Columns...>::resize(size_t count) {
+    resizeAll(count, std::index_sequence_for<Columns...>());
+}
+
+template<class... Columns>
+void EdgeColumns<Columns...>::push_back(const Columns &... values) {
+    pushAll(std::tuple<Columns...>(values...), std::index_sequence_for<Columns...>());
+}
+
+template<class... Columns>
+template<size_t I>
+typename EdgeColumns<Columns...>::template ColumnType<I> &EdgeColumns<Columns...>::column() {
+    return std::get<I>(columns);
+}
+
+template<class... Columns>
+template<size_t I>
+const typename EdgeColumns<Columns...>::template ColumnType<I> &EdgeColumns<Columns...>::column() const {
+    return std::get<I>(columns);
+}
+
+template<class... Columns>
+EdgeColumns<Columns...> EdgeColumns<Columns...>::gather(const std::vector<uint64_t> &origins) const {
+    return gatherAll(origins, std::index_sequence_for<Columns...>());
+}
+
+template<class... Columns>
+template<size_t... I>
+void EdgeColumns<Columns...>::resizeAll(size_t count, std::index_sequence<I...>) {
+    (std::get<I>(columns).resize(count), ...);
+}
+
+template<class... Columns>
+template<size_t... I>
+void EdgeColumns<Columns...>::pushAll(const std::tuple<Columns...> &values, std::index_sequence<I...>) {
+    (std::get<I>(columns).push_back(std::get<I>(values)), ...);
+}
+
+template<class... Columns>
+template<size_t... I>
+EdgeColumns<Columns...> EdgeColumns<Columns...>::gatherAll(const std::vector<uint64_t> &origins,
+                                                          std::index_sequence<I...>) const {
+    EdgeColumns<Columns...> result(origins.size());
+    // one column at a time, so each pass streams a single source and destination array
+    auto gatherColumn = [&origins](auto &to, const auto &from) {
+        for (size_t e = 0; e < origins.size(); e++) to[e] = from[origins[e]];
+    };
+    (gatherColumn(std::get<I>(result.columns), std::get<I>(columns)), ...);
+    return result;
+}
+
+#endif //GRAPHALGORITHM_EDGECOLUMNS_HPP
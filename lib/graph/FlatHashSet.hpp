@@ -0,0 +1,367 @@
+#ifndef GRAPHALGORITHM_FLATHASHSET_HPP
+#define GRAPHALGORITHM_FLATHASHSET_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "MemoryUsage.hpp"
+
+/**
+ * An open-addressing hash set with one control byte per slot, in the spirit of Swiss tables.
+ *
+ * Keys live inline in a single array and a parallel array of control bytes holds, for every
+ * slot, either EMPTY, DELETED or the low 7 bits of the key hash. A lookup probes linearly and
+ * only compares keys whose control byte matches, so there is no node allocation per element
+ * and no pointer chasing. An empty set allocates nothing, which matters for the many
+ * low-degree adjacency sets of a graph.
+ *
+ * Inserting may move every element: unlike std::unordered_set, references and iterators are
+ * invalidated by insertion.
+ *
+ * @tparam K key type, default constructible
+ * @tparam Hash hash functor, its result is re-mixed so weak hashes (e.g. identity) are fine
+ * @tparam Equal equality functor
+ * @tparam Allocator allocator of the slots, rebound for the control bytes; the set is
+ *         allocator-aware, so a std::pmr container of FlatHashSet passes its resource down
+ */
+template<class K, class Hash = std::hash<K>, class Equal = std::equal_to<K>, class Allocator = std::allocator<K>>
+class FlatHashSet {
+    static constexpr int8_t EMPTY = -128;
+    static constexpr int8_t DELETED = -2;
+    static constexpr size_t MIN_CAPACITY = 4;
+
+    using ControlAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<int8_t>;
+
+    std::vector<K, Allocator> slots;
+    std::vector<int8_t, ControlAllocator> control;
+    size_t elements = 0;
+    size_t used = 0;
+
+    static uint64_t mix(uint64_t x);
+
+    /**
+     * @return The slot holding key, or slots.size() if absent.
+     */
+    size_t locate(const K &key, uint64_t hash) const;
+
+    /**
+     * @brief Rebuilds the table with the given power of two capacity, dropping tombstones.
+     */
+    void rehash(size_t capacity);
+
+public:
+    class const_iterator {
+        const FlatHashSet *set = nullptr;
+        size_t index = 0;
+
+        void skip() {
+            while (index < set->control.size() && set->control[index] < 0) ++index;
+        }
+
+        friend class FlatHashSet;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = K;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const K *;
+        using reference = const K &;
+
+        const_iterator() = default;
+        const_iterator(const FlatHashSet *set, size_t index) : set(set), index(index) { skip(); }
+
+        reference operator*() const { return set->slots[index]; }
+        pointer operator->() const { return &set->slots[index]; }
+
+        const_iterator &operator++() {
+            ++index;
+            skip();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator &rhs) const { return index == rhs.index; }
+        bool operator!=(const const_iterator &rhs) const { return index != rhs.index; }
+    };
+
+    using iterator = const_iterator;
+    using value_type = K;
+    using allocator_type = Allocator;
+
+    FlatHashSet() = default;
+    FlatHashSet(const FlatHashSet &) = default;
+    FlatHashSet &operator=(const FlatHashSet &) = default;
+
+    // a moved-from set is left empty, not just with empty arrays
+    FlatHashSet(FlatHashSet &&other) noexcept
+        : slots(std::move(other.slots)), control(std::move(other.control)),
+          elements(std::exchange(other.elements, 0)), used(std::exchange(other.used, 0)) {}
+
+    FlatHashSet &operator=(FlatHashSet &&other) noexcept {
+        slots = std::move(other.slots);
+        control = std::move(other.control);
+        elements = std::exchange(other.elements, 0);
+        used = std::exchange(other.used, 0);
+        return *this;
+    }
+
+    explicit FlatHashSet(const Allocator &allocator)
+        : slots(allocator), control(ControlAllocator(allocator)) {}
+
+    FlatHashSet(const FlatHashSet &other, const Allocator &allocator)
+        : slots(other.slots, allocator), control(other.control, ControlAllocator(allocator)),
+          elements(other.elements), used(other.used) {}
+
+    FlatHashSet(FlatHashSet &&other, const Allocator &allocator)
+        : slots(std::move(other.slots), allocator), control(std::move(other.control), ControlAllocator(allocator)),
+          elements(other.elements), used(other.used) {
+        // with a different allocator the arrays were copied, not stolen
+        other.clear();
+    }
+
+    /**
+     * @return The allocator of the slots.
+     */
+    allocator_type get_allocator() const { return slots.get_allocator(); }
+
+    /**
+     * @return Number of elements.
+     */
+    size_t size() const;
+
+    /**
+     * @return True if there is no element.
+     */
+    bool empty() const;
+
+    /**
+     * @return Number of slots currently allocated.
+     */
+    size_t capacity() const;
+
+    /**
+     * @return The bytes of the slot and control arrays.
+     */
+    MemoryUsage memoryUsage() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /**
+     * @return An iterator to the element equal to key, or end().
+     */
+    const_iterator find(const K &key) const;
+
+    /**
+     * @return 1 if an element equal to key is present, 0 otherwise.
+     */
+    size_t count(const K &key) const;
+
+    /**
+     * @return True if an element equal to key is present.
+     */
+    bool contains(const K &key) const;
+
+    /**
+     * @brief Inserts key unless an equal element is already present (which is then kept unchanged).
+     *
+     * @return The position of the element and whether it was inserted.
+     */
+    std::pair<const_iterator, bool> insert(const K &key);
+
+    /**
+     * @brief Inserts key without looking for an equal element first.
+     *
+     * Only for keys known to be absent, such as a deduplicated run filling an empty set; an equal
+     * element already present would end up stored twice.
+     */
+    void insertUnique(const K &key);
+
+    /**
+     * @brief Removes the element equal to key.
+     *
+     * @return The number of removed elements (0 or 1).
+     */
+    size_t erase(const K &key);
+
+    /**
+     * @brief Removes every element and releases the storage.
+     */
+    void clear();
+
+    /**
+     * @brief Grows the table so that n elements fit without rehashing.
+     */
+    void reserve(size_t n);
+};
+
+template<class K, class Hash, class Equal, class Allocator>
+uint64_t FlatHashSet<K, Hash, Equal, Allocator>::mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+size_t FlatHashSet<K, Hash, Equal, Allocator>::locate(const K &key, uint64_t hash) const {
+    if (slots.empty()) return 0;
+
+    const size_t mask = slots.size() - 1;
+    const int8_t tag = static_cast<int8_t>(hash & 0x7F);
+    for (size_t i = (hash >> 7) & mask;; i = (i + 1) & mask) {
+        if (control[i] == EMPTY) return slots.size();
+        if (control[i] == tag && Equal()(slots[i], key)) return i;
+    }
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+void FlatHashSet<K, Hash, Equal, Allocator>::rehash(size_t capacity) {
+    std::vector<K, Allocator> oldSlots = std::move(slots);
+    std::vector<int8_t, ControlAllocator> oldControl = std::move(control);
+    slots.assign(capacity, K());
+    control.assign(capacity, EMPTY);
+
+    const size_t mask = capacity - 1;
+    for (size_t j = 0; j < oldSlots.size(); j++) {
+        if (oldControl[j] < 0) continue;
+
+        const uint64_t hash = mix(Hash()(oldSlots[j]));
+        size_t i = (hash >> 7) & mask;
+        while (control[i] != EMPTY) i = (i + 1) & mask;
+        control[i] = static_cast<int8_t>(hash & 0x7F);
+        slots[i] = std::move(oldSlots[j]);
+    }
+    used = elements;
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+size_t FlatHashSet<K, Hash, Equal, Allocator>::size() const {
+    return elements;
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+bool FlatHashSet<K, Hash, Equal, Allocator>::empty() const {
+    return elements == 0;
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+size_t FlatHashSet<K, Hash, Equal, Allocator>::capacity() const {
+    return slots.size();
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+MemoryUsage FlatHashSet<K, Hash, Equal, Allocator>::memoryUsage() const {
+    MemoryUsage usage = MemoryUsage::of(slots);
+    usage += MemoryUsage::of(control);
+    return usage;
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+typename FlatHashSet<K, Hash, Equal, Allocator>::const_iterator FlatHashSet<K, Hash, Equal, Allocator>::begin() const {
+    return const_iterator(this, 0);
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+typename FlatHashSet<K, Hash, Equal, Allocator>::const_iterator FlatHashSet<K, Hash, Equal, Allocator>::end() const {
+    return const_iterator(this, slots.size());
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+typename FlatHashSet<K, Hash, Equal, Allocator>::const_iterator FlatHashSet<K, Hash, Equal, Allocator>::find(const K &key) const {
+    return const_iterator(this, locate(key, mix(Hash()(key))));
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+size_t FlatHashSet<K, Hash, Equal, Allocator>::count(const K &key) const {
+    return contains(key) ? 1 : 0;
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+bool FlatHashSet<K, Hash, Equal, Allocator>::contains(const K &key) const {
+    return locate(key, mix(Hash()(key))) != slots.size();
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+std::pair<typename FlatHashSet<K, Hash, Equal, Allocator>::const_iterator, bool> FlatHashSet<K, Hash, Equal, Allocator>::insert(const K &key) {
+    const uint64_t hash = mix(Hash()(key));
+    size_t found = locate(key, hash);
+    if (found != slots.size()) return {const_iterator(this, found), false};
+
+    // keep at least 1/8 of the slots EMPTY so every probe terminates
+    if ((used + 1) * 8 > slots.size() * 7)
+        rehash(slots.empty() ? MIN_CAPACITY : (elements + 1) * 8 > slots.size() * 4 ? slots.size() * 2 : slots.size());
+
+    const size_t mask = slots.size() - 1;
+    size_t i = (hash >> 7) & mask;
+    while (control[i] >= 0) i = (i + 1) & mask;
+
+    if (control[i] == EMPTY) used++;
+    control[i] = static_cast<int8_t>(hash & 0x7F);
+    slots[i] = key;
+    elements++;
+    return {const_iterator(this, i), true};
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+void FlatHashSet<K, Hash, Equal, Allocator>::insertUnique(const K &key) {
+    const uint64_t hash = mix(Hash()(key));
+    if ((used + 1) * 8 > slots.size() * 7)
+        rehash(slots.empty() ? MIN_CAPACITY : (elements + 1) * 8 > slots.size() * 4 ? slots.size() * 2 : slots.size());
+
+    // the first free slot of the probe sequence, without comparing any key
+    const size_t mask = slots.size() - 1;
+    size_t i = (hash >> 7) & mask;
+    while (control[i] >= 0) i = (i + 1) & mask;
+
+    if (control[i] == EMPTY) used++;
+    control[i] = static_cast<int8_t>(hash & 0x7F);
+    slots[i] = key;
+    elements++;
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+size_t FlatHashSet<K, Hash, Equal, Allocator>::erase(const K &key) {
+    size_t i = locate(key, mix(Hash()(key)));
+    if (i == slots.size()) return 0;
+
+    // with linear probing no chain runs past an EMPTY slot, so the tombstone can be skipped
+    const size_t mask = slots.size() - 1;
+    if (control[(i + 1) & mask] == EMPTY) {
+        control[i] = EMPTY;
+        used--;
+    } else {
+        control[i] = DELETED;
+    }
+    slots[i] = K();
+    elements--;
+    return 1;
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+void FlatHashSet<K, Hash, Equal, Allocator>::clear() {
+    slots.clear();
+    slots.shrink_to_fit();
+    control.clear();
+    control.shrink_to_fit();
+    elements = 0;
+    used = 0;
+}
+
+template<class K, class Hash, class Equal, class Allocator>
+void FlatHashSet<K, Hash, Equal, Allocator>::reserve(size_t n) {
+    size_t capacity = MIN_CAPACITY;
+    while (capacity * 7 < n * 8 + 8) capacity *= 2;
+    if (capacity > slots.size()) rehash(capacity);
+}
+
+#endif //GRAPHALGORITHM_FLATHASHSET_HPP
@@ -11,27 +11,121 @@
 #include <set>
 
 #include <algorithm>
+#include <iterator>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
 
 #include "Edge.hpp"
+#include "FlatHashSet.hpp"
+#include "GraphViews.hpp"
+#include "Instrumentation.hpp"
+#include "OutputBuffer.hpp"
 
 /**
  * A class that's represents a graph and its connections (edges)
  *
  * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges, e.g. uint16_t, uint32_t, float or double
+ * @tparam Allocator allocator of the adjacency map and edge tables: std::allocator, or a
+ *         std::pmr::polymorphic_allocator (see PmrGraph) to keep the whole graph in one memory
+ *         resource, e.g. a std::pmr::unsynchronized_pool_resource released in one go
  */
-template<class T>
+template<class T, class W = double, class Allocator = std::allocator<T>>
 class Graph {
+    template<class U>
+    using Rebind = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+public:
+    using allocator_type = Allocator;
+
+    /**
+     * Set of edges used for every adjacency list: a flat open-addressing table, so no
+     * allocation per edge.
+     */
+    using EdgeSet = FlatHashSet<Edge<T, W>, std::hash<Edge<T, W>>, std::equal_to<Edge<T, W>>, Rebind<Edge<T, W>>>;
+
+    // node-based map on purpose: references to the adjacency sets must survive rehashing.
+    // Each node hands its allocator to its EdgeSet (uses-allocator construction).
+    using AdjacencyMap = std::unordered_map<T, EdgeSet, std::hash<T>, std::equal_to<T>,
+                                            Rebind<std::pair<const T, EdgeSet>>>;
+
 protected:
-    std::unordered_map<T, std::unordered_set<Edge<T>>> graph;
-    std::unordered_set<T> vertices;
-    std::unordered_set<Edge<T>> edges;
+    // the adjacency map is the only copy of the graph, vertices and edges are views over it
+    AdjacencyMap graph;
+    size_t edgeCount = 0;
+
+    virtual void edgeTo(const T &from, const T &to, W weight);
+
+    /**
+     * An arc between interned vertex ids, used by bulkInsert.
+     */
+    struct IdArc {
+        uint32_t from;
+        uint32_t to;
+        W weight;
+    };
+
+    /**
+     * @brief Links arcs grouped by tail (one contiguous run per vertex) and free of duplicates,
+     * touching each adjacency set once.
+     *
+     * @param ids The vertex of every interned id.
+     * @param arcs The arcs, both directions included for an undirected graph.
+     */
+    virtual void linkSorted(const std::vector<T> &ids, const std::vector<IdArc> &arcs);
+
+    template<class Range>
+    static auto sizeHint(const Range &range, int) -> decltype(size_t(std::size(range))) { return std::size(range); }
+
+    template<class Range>
+    static size_t sizeHint(const Range &, long) { return 0; }
 
-    virtual void edgeTo(const T &from, const T &to, int weight);
+    static void writeDotId(OutputBuffer &out, const T &id);
 
 public:
+    /**
+     * Filters applied by writeDot so that only part of a big graph is dumped.
+     */
+    struct DotOptions {
+        /**
+         * When set, only the subgraph induced by these vertices is written.
+         */
+        const std::unordered_set<T> *vertices = nullptr;
+
+        /**
+         * Fraction of the edges kept, chosen by hashing both ends of each edge (in either order
+         * for an undirected graph) so the sample does not depend on the iteration order.
+         */
+        double sampleRate = 1.0;
+
+        /**
+         * Changes which edges are picked when sampleRate < 1.
+         */
+        uint64_t seed = 0;
+
+        /**
+         * Stop after this many edges.
+         */
+        size_t maxEdges = std::numeric_limits<size_t>::max();
+    };
+
     // constructors and delete
     Graph();
-    ~Graph();
+
+    /**
+     * @param allocator Allocates the adjacency map and every edge table.
+     */
+    explicit Graph(const Allocator &allocator);
+    Graph(const Graph<T, W, Allocator> &) = default;
+    Graph(Graph<T, W, Allocator> &&) noexcept = default;
+    Graph<T, W, Allocator> &operator=(const Graph<T, W, Allocator> &) = default;
+    Graph<T, W, Allocator> &operator=(Graph<T, W, Allocator> &&) noexcept = default;
+    virtual ~Graph();
 
     // insertions
     /**
@@ -48,7 +142,20 @@ public:
      * @param to The destination vertex linked from the origin (from)
      * @param weight The weight of the edge.
      */
-    virtual void addEdge(const T &from, const T &to, int weight);
+    virtual void addEdge(const T &from, const T &to, W weight);
+
+    /**
+     * @brief Adds many edges at once, 2 to 3 times faster than calling addEdge for each of them
+     * (build_bench, 1M random edges).
+     *
+     * Vertices are interned to dense ids, the arcs are grouped by tail with a counting sort and
+     * deduplicated (the first occurrence of an edge wins, as with addEdge), and every adjacency
+     * set that was empty is then filled from its run in a single pass, with no duplicate check.
+     *
+     * @param range Any iterable of (from, to, weight) triples: std::tuple, or a struct with three public members.
+     */
+    template<class Range>
+    void bulkInsert(const Range &range);
 
      // removal methods
      /**
@@ -66,7 +173,7 @@ public:
      * @param data The vertex to be find
      * @return Read-only set with all adjacent of data
      */
-    const std::unordered_set<Edge<T>> &getAdjacent(const T &data);
+    const EdgeSet &getAdjacent(const T &data);
 
     /**
      * @brief Find all vertices adjacent to the given value
@@ -74,36 +181,85 @@ public:
      * @param findValue The vertex to be find
      * @return A read-only set with all adjacent of data
      */
-    const std::unordered_set<Edge<T>> &operator[](const T &findValue);
+    const EdgeSet &operator[](const T &findValue);
 
     /**
      *
-     * @return A read-only set containing all vertices in the graph
+     * @return A read-only view of all vertices in the graph (iterable, size, find, count, contains)
      */
-    const std::unordered_set<T> &getVertices() const;
+    VertexView<AdjacencyMap> getVertices() const;
+
+    /**
+     * @return True if edges are one-way (Digraph), false otherwise
+     */
+    virtual bool isDirected() const;
 
     /**
      *
      * @return an String to be plotted on  <a ref="https://dreampuf.github.io/GraphvizOnline/">graphviz</a>
      */
-    std::string toDot();
+    std::string toDot() const;
 
+    /**
+     * @brief Streams the graph in Graphviz format without building the document in memory.
+     *
+     * Output goes through a large OutputBuffer. An undirected graph is written as "graph { u -- v }"
+     * with each edge once, a directed one as "digraph { u -> v }". Vertices without edges are
+     * written as bare nodes.
+     *
+     * @param os The stream that receives the document.
+     */
+    void writeDot(std::ostream &os) const;
+
+    /**
+     * @brief Same as writeDot(os), keeping only the vertices and edges selected by options.
+     */
+    void writeDot(std::ostream &os, const DotOptions &options) const;
 
     /**
-    * @brief Get a read-only set containing edges in the graph.
+     * @brief Same as writeDot(os) for a C stream.
+     */
+    void writeDot(FILE *out) const;
+
+    /**
+     * @brief Same as writeDot(os, options) for a C stream.
+     */
+    void writeDot(FILE *out, const DotOptions &options) const;
+
+    /**
+     * @brief Writes the graph to an already open buffer, see writeDot(os).
+     */
+    void writeDot(OutputBuffer &out, const DotOptions &options) const;
+
+
+    /**
+    * @brief Get a read-only view of the edges in the graph.
     *  In an undirected graph, both (u, v) and (v, u) edges are included.
     * 
-    * @return A read-only set containing edges in the graph.
+    * @return A read-only view of the edges (iterable, size, find, count, contains).
     */
-    const std::unordered_set<Edge<T>> &getEdges() const;
+    EdgeView<AdjacencyMap> getEdges() const;
 
     /**
      * @return True if the graph contains at last one vertex, false otherwise 
      */
     bool isEmpty() const;
 
+    /**
+     * @brief Bytes held by the graph: the bucket array and vertex nodes of the adjacency map
+     * (buckets, nodes) and the flat edge tables of every vertex (elements).
+     *
+     * getVertices and getEdges are views over the adjacency map and own nothing.
+     */
+    virtual MemoryUsage memoryUsage() const;
+
+    /**
+     * @return The allocator the graph was built with.
+     */
+    allocator_type getAllocator() const;
+
     // print
-    friend std::ostream &operator<<(std::ostream &os, const Graph<T> &graf) {
+    friend std::ostream &operator<<(std::ostream &os, const Graph<T, W, Allocator> &graf) {
         for (const auto &[key, value]: graf.graph) {
             if (!value.empty()) os << key << " - ";
             else os << key;
@@ -118,117 +274,322 @@ public:
     }
 };
 
-template<class T>
-bool Graph<T>::isEmpty() const {
+template<class T, class W, class Allocator>
+bool Graph<T, W, Allocator>::isEmpty() const {
     return this->graph.empty();
 }
 
-template<class T>
-const std::unordered_set<Edge<T>> &Graph<T>::getEdges() const {
-    return edges;
+template<class T, class W, class Allocator>
+MemoryUsage Graph<T, W, Allocator>::memoryUsage() const {
+    MemoryUsage usage = MemoryUsage::of(graph);
+    for (const auto &entry : graph) usage += entry.second.memoryUsage();
+    return usage;
 }
 
-template<class T>
-const std::unordered_set<T> &Graph<T>::getVertices() const {
-    return this->vertices;
+template<class T, class W, class Allocator>
+EdgeView<typename Graph<T, W, Allocator>::AdjacencyMap> Graph<T, W, Allocator>::getEdges() const {
+    return EdgeView<AdjacencyMap>(graph, edgeCount);
 }
 
-template<class T>
-void Graph<T>::edgeTo(const T &from, const T &to, int weight) {
-    Edge<T> ed1(from, to, weight);
+template<class T, class W, class Allocator>
+VertexView<typename Graph<T, W, Allocator>::AdjacencyMap> Graph<T, W, Allocator>::getVertices() const {
+    return VertexView<AdjacencyMap>(graph);
+}
+
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::edgeTo(const T &from, const T &to, W weight) {
+    Edge<T, W> ed1(from, to, weight);
 
-    if (edges.find(ed1) == edges.end())
-        edges.insert(ed1);
+    // references into the map stay valid when the second try_emplace rehashes
+    EdgeSet &adjacent = graph.try_emplace(from).first->second;
+    graph.try_emplace(to);
 
-    if (graph.find(from) == graph.end()) {
-        graph[from] = std::unordered_set<Edge<T>>();
-        this->vertices.insert(from);
+    if (adjacent.insert(ed1).second)
+        edgeCount++;
+}
+
+template<class T, class W, class Allocator>
+template<class Range>
+void Graph<T, W, Allocator>::bulkInsert(const Range &range) {
+    std::unordered_map<T, uint32_t> index;
+    std::vector<T> ids;
+    std::vector<IdArc> arcs;
+
+    auto intern = [&](const T &vertex) {
+        auto [it, added] = index.try_emplace(vertex, (uint32_t) ids.size());
+        if (added) ids.push_back(vertex);
+        return it->second;
+    };
+
+    const bool directed = isDirected();
+    const size_t expected = sizeHint(range, 0);
+    index.reserve(expected);
+    arcs.reserve(expected * (directed ? 1 : 2));
+
+    for (const auto &[from, to, weight] : range) {
+        uint32_t u = intern(from), v = intern(to);
+        // an undirected edge is canonicalized so (u, v) and (v, u) dedupe together
+        if (!directed && v < u) std::swap(u, v);
+        arcs.push_back({u, v, static_cast<W>(weight)});
     }
 
-    if (graph.find(to) == graph.end()) {
-        graph[to] = std::unordered_set<Edge<T>>();
-        this->vertices.insert(to);
+    // counting sort by tail, stable so that among duplicates the first one given is kept, like
+    // repeated addEdge calls; then each run, a single vertex's arcs, is sorted by head on its own
+    auto groupByTail = [&](const std::vector<IdArc> &input, bool mirror) {
+        std::vector<size_t> start(ids.size() + 1, 0);
+        for (const IdArc &arc : input) {
+            start[arc.from + 1]++;
+            if (mirror && arc.from != arc.to) start[arc.to + 1]++;
+        }
+        for (size_t v = 0; v < ids.size(); v++) start[v + 1] += start[v];
+
+        std::vector<IdArc> grouped(start.back());
+        for (const IdArc &arc : input) {
+            grouped[start[arc.from]++] = arc;
+            if (mirror && arc.from != arc.to) grouped[start[arc.to]++] = {arc.to, arc.from, arc.weight};
+        }
+        return grouped;
+    };
+    auto byHead = [](const IdArc &a, const IdArc &b) { return a.to < b.to; };
+
+    arcs = groupByTail(arcs, false);
+    size_t kept = 0;
+    for (size_t begin = 0, end; begin < arcs.size(); begin = end) {
+        end = begin;
+        while (end < arcs.size() && arcs[end].from == arcs[begin].from) end++;
+        std::stable_sort(arcs.begin() + begin, arcs.begin() + end, byHead);
+        for (size_t i = begin; i < end; i++)
+            if (i == begin || arcs[i].to != arcs[i - 1].to) arcs[kept++] = arcs[i];
     }
+    arcs.resize(kept);
 
+    // an undirected edge is stored at both ends: regroup with the mirrored arcs, whose heads are
+    // unique within each run too since every canonical (u, v) has u <= v
+    if (!directed) arcs = groupByTail(arcs, true);
 
+    linkSorted(ids, arcs);
+}
 
-    if (edges.find(ed1) == edges.end())
-        this->edges.insert(ed1);
-    graph[from].insert(ed1);
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::linkSorted(const std::vector<T> &ids, const std::vector<IdArc> &arcs) {
+    graph.reserve(graph.size() + ids.size());
+    for (const T &vertex : ids)
+        graph.try_emplace(vertex);
+
+    for (size_t begin = 0, end; begin < arcs.size(); begin = end) {
+        end = begin;
+        while (end < arcs.size() && arcs[end].from == arcs[begin].from) end++;
+
+        const T &from = ids[arcs[begin].from];
+        EdgeSet &adjacent = graph[from];
+        adjacent.reserve(adjacent.size() + (end - begin));
+
+        // the run is sorted and unique: a vertex without edges yet takes it with no equality probe
+        if (adjacent.empty()) {
+            for (size_t i = begin; i < end; i++) adjacent.insertUnique(Edge<T, W>(from, ids[arcs[i].to], arcs[i].weight));
+            edgeCount += end - begin;
+            continue;
+        }
+        for (size_t i = begin; i < end; i++) {
+            Edge<T, W> edge(from, ids[arcs[i].to], arcs[i].weight);
+            if (adjacent.insert(edge).second) edgeCount++;
+        }
+    }
 }
 
-template<class T>
-Graph<T>::Graph() = default;
+template<class T, class W, class Allocator>
+Graph<T, W, Allocator>::Graph() = default;
 
-template<class T>
-Graph<T>::~Graph() = default;
+template<class T, class W, class Allocator>
+Graph<T, W, Allocator>::Graph(const Allocator &allocator)
+    : graph(typename AdjacencyMap::allocator_type(allocator)) {}
 
-template<class T>
-void Graph<T>::addVertex(const T &from) {
-    if (graph.find(from) == graph.end()) {
-        this->vertices.insert(from);
-        graph[from] = std::unordered_set<Edge<T>>();
-    }
+template<class T, class W, class Allocator>
+typename Graph<T, W, Allocator>::allocator_type Graph<T, W, Allocator>::getAllocator() const {
+    return allocator_type(graph.get_allocator());
+}
+
+template<class T, class W, class Allocator>
+Graph<T, W, Allocator>::~Graph() = default;
+
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::addVertex(const T &from) {
+    graph.try_emplace(from);
 }
 
-template<class T>
-void Graph<T>::addEdge(const T &from, const T &to, int weight) {
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::addEdge(const T &from, const T &to, W weight) {
     edgeTo(from, to, weight);
     edgeTo(to, from, weight);
 }
 
 
-template<class T>
-bool Graph<T>::removeVertex(const T &data) {
+template<class T, class W, class Allocator>
+bool Graph<T, W, Allocator>::removeVertex(const T &data) {
     auto it = graph.find(data);
-    this->vertices.erase(data);
 
     if (it != graph.end()) {
-        for (auto &edge: graph[data]) {
+        for (auto &edge: it->second) {
             const T &to = edge.getTo();
-            auto ed = Edge<T>(to, data, 0);
-            graph[to].erase(ed);
-            edges.erase(ed);
+            if (to == data) continue;
+            edgeCount -= graph.find(to)->second.erase(Edge<T, W>(to, data, 0));
         }
 
-        graph.erase(data);
+        edgeCount -= it->second.size();
+        graph.erase(it);
         return true;
     }
     return false;
 }
 
-template<class T>
-const std::unordered_set<Edge<T>> &Graph<T>::getAdjacent(const T &data) {
+template<class T, class W, class Allocator>
+const typename Graph<T, W, Allocator>::EdgeSet &Graph<T, W, Allocator>::getAdjacent(const T &data) {
+    Instrumentation::probed(graph, data);
+
     // Verificar se o vértice existe no grafo antes de retornar suas arestas
     auto it = graph.find(data);
     if (it != graph.end()) {
-        return graph[data];
+        return it->second;
     } else {
         // Retornar um conjunto vazio se o vértice não existir
-        static const std::unordered_set<Edge<T>> emptySet;
+        static const EdgeSet emptySet;
         return emptySet;
     }
 }
 
-template<class T>
-const std::unordered_set<Edge<T>> &Graph<T>::operator[](const T &findValue) {
+template<class T, class W, class Allocator>
+const typename Graph<T, W, Allocator>::EdgeSet &Graph<T, W, Allocator>::operator[](const T &findValue) {
     return getAdjacent(findValue);
 }
 
-template<class T>
-std::string Graph<T>::toDot() {
+template<class T, class W, class Allocator>
+bool Graph<T, W, Allocator>::isDirected() const {
+    return false;
+}
+
+template<class T, class W, class Allocator>
+std::string Graph<T, W, Allocator>::toDot() const {
     std::ostringstream sb;
-    sb << "graph {" << std::endl;
-    sb << "\trankdir = LR;" << std::endl;
-    sb << "\tnode [shape = circle];" << std::endl;
+    writeDot(sb);
+    return sb.str();
+}
+
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::writeDot(std::ostream &os) const {
+    writeDot(os, DotOptions());
+}
+
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::writeDot(std::ostream &os, const DotOptions &options) const {
+    OutputBuffer out(os);
+    writeDot(out, options);
+}
+
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::writeDot(FILE *out) const {
+    writeDot(out, DotOptions());
+}
+
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::writeDot(FILE *out, const DotOptions &options) const {
+    OutputBuffer buffer(out);
+    writeDot(buffer, options);
+}
+
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::writeDot(OutputBuffer &out, const DotOptions &options) const {
+    const bool directed = isDirected();
+    const char *connector = directed ? " -> " : " -- ";
+    const auto *selected = options.vertices;
+    const uint64_t threshold = options.sampleRate >= 1.0 ? std::numeric_limits<uint64_t>::max()
+            : (uint64_t) (std::max(options.sampleRate, 0.0) * 18446744073709551615.0);
+
+    auto keep = [&](uint64_t fromHash, uint64_t toHash) {
+        if (threshold == std::numeric_limits<uint64_t>::max()) return true;
+        // an undirected edge is the same whichever end it is read from
+        if (!directed && toHash < fromHash) std::swap(fromHash, toHash);
+        // splitmix64 finalizer over both endpoints, independent of the std::hash<Edge<T, W>> quality
+        uint64_t x = options.seed + fromHash * 0x9e3779b97f4a7c15ULL + toHash;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return (x ^ (x >> 31)) < threshold;
+    };
+
+    out.write(directed ? "digraph {\n" : "graph {\n");
+    out.write("\trankdir = LR;\n");
+    out.write("\tnode [shape = circle];\n");
+
+    // in an undirected graph (u, v) is emitted from the end with the smaller hash; only the
+    // vertices that share their hash with a neighbor are remembered, to emit such edges once
+    std::unordered_set<T> collided;
+    size_t written = 0;
+
     for (const auto &[k, v] : graph) {
-        for (auto it = v.begin(); it != v.end(); ++it) {
-                sb << '\t' << k << " -- " << (*it).getTo() << " [label = " << (*it).getWeight() << "];" << std::endl;
+        if (written >= options.maxEdges) break;
+        if (selected != nullptr && selected->find(k) == selected->end()) continue;
+
+        if (v.empty()) {
+            out.put('\t');
+            writeDotId(out, k);
+            out.write(";\n");
         }
+
+        const uint64_t fromHash = std::hash<T>()(k);
+        bool sharesHash = false;
+        for (const auto &edge : v) {
+            const T &to = edge.getTo();
+            const uint64_t toHash = std::hash<T>()(to);
+            if (!directed && !(to == k)) {
+                if (toHash < fromHash) continue;
+                if (toHash == fromHash) {
+                    sharesHash = true;
+                    if (collided.find(to) != collided.end()) continue;
+                }
+            }
+            if (selected != nullptr && selected->find(to) == selected->end()) continue;
+            if (!keep(fromHash, toHash)) continue;
+            if (written == options.maxEdges) break;
+            written++;
+
+            out.put('\t');
+            writeDotId(out, k);
+            out.write(connector);
+            writeDotId(out, to);
+            out.write(" [label = ");
+            out.writeNumber(edge.getWeight());
+            out.write("];\n");
+        }
+
+        if (sharesHash) collided.insert(k);
     }
 
-    sb << "}" << std::endl;
-    return sb.str();
+    out.write("}\n");
+}
+
+template<class T, class W, class Allocator>
+void Graph<T, W, Allocator>::writeDotId(OutputBuffer &out, const T &id) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        out.writeNumber(id);
+    } else if constexpr (std::is_convertible_v<const T &, std::string>) {
+        const std::string &text = id;
+        out.put('"');
+        for (char c : text) {
+            if (c == '"' || c == '\\') out.put('\\');
+            out.put(c);
+        }
+        out.put('"');
+    } else {
+        std::ostringstream sb;
+        sb << id;
+        out.write(sb.str());
+    }
 }
 
-#endif //GRAPHALGORITHM_GRAPH_HPP
\ No newline at end of file
+/**
+ * A Graph living in a std::pmr::memory_resource, e.g.
+ * std::pmr::unsynchronized_pool_resource pool; PmrGraph<int> graph(&pool);
+ */
+template<class T, class W = double>
+using PmrGraph = Graph<T, W, std::pmr::polymorphic_allocator<T>>;
+
+#endif //GRAPHALGORITHM_GRAPH_HPP
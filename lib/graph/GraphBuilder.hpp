@@ -0,0 +1,109 @@
+#ifndef GRAPHALGORITHM_GRAPHBUILDER_HPP
+#define GRAPHALGORITHM_GRAPHBUILDER_HPP
+
+#include <tuple>
+#include <vector>
+
+#include "Digraph.hpp"
+
+/**
+ * Collects edges and vertices, then builds a Graph or Digraph in one bulk pass.
+ *
+ * Meant for loading: add() only appends to a vector, and the hashing, deduplication
+ * and adjacency construction happen once in buildGraph()/buildDigraph() through
+ * Graph::bulkInsert.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges
+ */
+template<class T, class W = double>
+class GraphBuilder {
+    std::vector<std::tuple<T, T, W>> pending;
+    std::vector<T> isolated;
+
+    template<class G>
+    void fill(G &graph);
+
+public:
+    GraphBuilder() = default;
+
+    /**
+     * @brief Reserves room for the given number of edges.
+     */
+    void reserve(size_t edges);
+
+    /**
+     * @brief Queues a vertex, useful for vertices that have no edge.
+     */
+    GraphBuilder<T, W> &addVertex(const T &vertex);
+
+    /**
+     * @brief Queues an edge. For an undirected build (u, v) and (v, u) are the same edge.
+     */
+    GraphBuilder<T, W> &addEdge(const T &from, const T &to, W weight);
+
+    /**
+     * @return The number of edges queued so far.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Builds an undirected graph from everything queued and empties the builder.
+     */
+    Graph<T, W> buildGraph();
+
+    /**
+     * @brief Builds a directed graph from everything queued and empties the builder.
+     *
+     * @param trackInEdges Whether the result maintains its in-edge index.
+     */
+    Digraph<T, W> buildDigraph(bool trackInEdges = false);
+};
+
+template<class T, class W>
+void GraphBuilder<T, W>::reserve(size_t edges) {
+    pending.reserve(edges);
+}
+
+template<class T, class W>
+GraphBuilder<T, W> &GraphBuilder<T, W>::addVertex(const T &vertex) {
+    isolated.push_back(vertex);
+    return *this;
+}
+
+template<class T, class W>
+GraphBuilder<T, W> &GraphBuilder<T, W>::addEdge(const T &from, const T &to, W weight) {
+    pending.emplace_back(from, to, weight);
+    return *this;
+}
+
+template<class T, class W>
+size_t GraphBuilder<T, W>::size() const {
+    return pending.size();
+}
+
+template<class T, class W>
+template<class G>
+void GraphBuilder<T, W>::fill(G &graph) {
+    graph.bulkInsert(pending);
+    for (const T &vertex : isolated) graph.addVertex(vertex);
+
+    pending = std::vector<std::tuple<T, T, W>>();
+    isolated = std::vector<T>();
+}
+
+template<class T, class W>
+Graph<T, W> GraphBuilder<T, W>::buildGraph() {
+    Graph<T, W> graph;
+    fill(graph);
+    return graph;
+}
+
+template<class T, class W>
+Digraph<T, W> GraphBuilder<T, W>::buildDigraph(bool trackInEdges) {
+    Digraph<T, W> graph(trackInEdges);
+    fill(graph);
+    return graph;
+}
+
+#endif //GRAPHALGORITHM_GRAPHBUILDER_HPP
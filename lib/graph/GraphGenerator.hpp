@@ -0,0 +1,381 @@
+#ifndef GRAPHALGORITHM_GRAPHGENERATOR_HPP
+#define GRAPHALGORITHM_GRAPHGENERATOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "CsrGraph.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Options shared by every GraphGenerator entry point.
+ */
+struct GeneratorOptions {
+    /**
+     * Seed of the random streams; the same seed and parameters give the same graph.
+     */
+    uint64_t seed = 1;
+
+    /**
+     * Edge weights are drawn uniformly in [minWeight, maxWeight] (rounded for integral weights).
+     */
+    double minWeight = 1;
+    double maxWeight = 100;
+
+    /**
+     * Number of generating threads, 0 means the whole ThreadPool::global(). The output does not
+     * depend on it.
+     */
+    unsigned threads = 0;
+};
+
+/**
+ * Synthetic graphs for benchmarks, hardware sizing and tests, produced as arc lists ready for
+ * CsrGraph::fromArcs (or GraphBuilder), never through per-edge insertion.
+ *
+ * Every arc (or point) draws its random numbers from its own counter-based stream, seeded with
+ * the options seed and the arc index. Arcs are therefore generated in parallel on the shared
+ * ThreadPool, and the output is identical for every thread count. Self-loops and repeated arcs
+ * are kept as drawn, like the file loaders do.
+ *
+ * @tparam W weight type of the arcs
+ */
+template<class W = double>
+class GraphGenerator {
+public:
+    using Arc = typename CsrGraph<W>::Arc;
+    using VertexId = typename CsrGraph<W>::VertexId;
+
+private:
+    /**
+     * A splitmix64 stream: cheap to seed at any index, which is what makes generation order free.
+     */
+    class Stream {
+        uint64_t state;
+
+    public:
+        Stream(uint64_t seed, uint64_t index) : state(seed ^ (index * 0x9e3779b97f4a7c15ULL)) { next(); }
+
+        uint64_t next() {
+            uint64_t x = (state += 0x9e3779b97f4a7c15ULL);
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        double unit() { return (double) (next() >> 11) * 0x1.0p-53; }
+
+        uint64_t below(uint64_t bound) { return (uint64_t) (unit() * (double) bound) % bound; }
+    };
+
+    static W scaleWeight(double unit, const GeneratorOptions &options);
+
+    /**
+     * @brief Sets arcs[i] = make(i, stream of arc i) for every i, in parallel.
+     */
+    template<class Make>
+    static std::vector<Arc> generate(size_t count, const GeneratorOptions &options, Make make);
+
+    static void checkVertices(size_t vertices);
+
+public:
+    /**
+     * @brief Recursive matrix (R-MAT) graph: every arc picks one quadrant of the adjacency
+     * matrix per bit with probabilities a, b, c and 1 - a - b - c, which gives the skewed
+     * degrees and community structure of real networks.
+     *
+     * @param scale The graph has 2^scale vertices.
+     * @param edges Number of arcs drawn.
+     */
+    static std::vector<Arc> rmat(unsigned scale, size_t edges, const GeneratorOptions &options,
+                                 double a = 0.57, double b = 0.19, double c = 0.19);
+
+    /**
+     * @brief The Graph500 Kronecker generator: R-MAT with (0.57, 0.19, 0.19) and edgeFactor * 2^scale
+     * arcs, whose vertex ids are then scrambled by a seeded bijection so that the hubs are not
+     * the low ids.
+     */
+    static std::vector<Arc> kronecker(unsigned scale, size_t edgeFactor, const GeneratorOptions &options);
+
+    /**
+     * @brief Erdős–Rényi G(n, m) graph: every arc joins two uniformly drawn vertices.
+     */
+    static std::vector<Arc> erdosRenyi(size_t vertices, size_t edges, const GeneratorOptions &options);
+
+    /**
+     * @brief A rows x columns 2D grid, vertex r * columns + c linked to its right and lower neighbours.
+     */
+    static std::vector<Arc> grid(size_t rows, size_t columns, const GeneratorOptions &options);
+
+    /**
+     * @brief Chung–Lu graph whose expected degrees follow a power law: vertex i has weight
+     * (i + 1)^(-1 / (exponent - 1)) and both endpoints of every arc are drawn proportionally to it,
+     * by inverting the continuous cumulative weight in O(1).
+     *
+     * @param exponent Exponent of the degree distribution, greater than 1 (typically 2 to 3).
+     */
+    static std::vector<Arc> powerLaw(size_t vertices, size_t edges, const GeneratorOptions &options,
+                                     double exponent = 2.1);
+
+    /**
+     * @brief Barabási–Albert preferential attachment: vertex v links to m earlier endpoints chosen
+     * proportionally to their degree.
+     *
+     * Uses the Batagelj–Brandes edge-copy formulation, where the target of arc i copies a uniformly
+     * drawn earlier endpoint. Following these copies back to an origin, as Sanders and Schulz
+     * do, resolves every arc on its own, so arcs are generated in parallel.
+     *
+     * @param m Arcs added by every vertex; the result has vertices * m arcs, some of them self-loops.
+     */
+    static std::vector<Arc> barabasiAlbert(size_t vertices, size_t m, const GeneratorOptions &options);
+
+    /**
+     * @brief Watts–Strogatz small world: a ring where every vertex links to its k / 2 next
+     * neighbours, each arc being rewired to a uniformly drawn vertex with probability beta.
+     *
+     * @param k Even mean degree of the ring lattice.
+     * @param beta Rewiring probability in [0, 1].
+     */
+    static std::vector<Arc> wattsStrogatz(size_t vertices, size_t k, double beta, const GeneratorOptions &options);
+
+    /**
+     * @brief Random geometric graph: vertices are uniform points of the unit square, linked (once,
+     * from the lower id) when closer than radius. The weight grows linearly with the distance,
+     * from minWeight for coincident points to maxWeight at the radius.
+     *
+     * Points are bucketed in a grid of radius-sized cells, so only neighbouring cells are compared.
+     * A radius of sqrt(d / (pi * vertices)) gives a mean degree of about d.
+     */
+    static std::vector<Arc> randomGeometric(size_t vertices, double radius, const GeneratorOptions &options);
+};
+
+template<class W>
+W GraphGenerator<W>::scaleWeight(double unit, const GeneratorOptions &options) {
+    const double value = options.minWeight + unit * (options.maxWeight - options.minWeight);
+    if constexpr (std::is_integral_v<W>) return static_cast<W>(std::llround(value));
+    else return static_cast<W>(value);
+}
+
+template<class W>
+template<class Make>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::generate(size_t count, const GeneratorOptions &options,
+                                                                         Make make) {
+    std::vector<Arc> arcs(count);
+    ParallelOptions parallel;
+    parallel.threads = options.threads;
+    ThreadPool::global().parallelFor(0, count, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            Stream stream(options.seed, i);
+            arcs[i] = make(i, stream);
+        }
+    }, parallel);
+    return arcs;
+}
+
+template<class W>
+void GraphGenerator<W>::checkVertices(size_t vertices) {
+    if (vertices == 0 || vertices - 1 > std::numeric_limits<VertexId>::max())
+        throw std::length_error("GraphGenerator: vertex count must be in [1, 2^32]");
+}
+
+template<class W>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::rmat(unsigned scale, size_t edges,
+                                                                     const GeneratorOptions &options,
+                                                                     double a, double b, double c) {
+    checkVertices(size_t(1) << scale);
+    return generate(edges, options, [&](size_t, Stream &stream) {
+        VertexId from = 0, to = 0;
+        for (unsigned bit = 0; bit < scale; bit++) {
+            const double p = stream.unit();
+            const bool down = p >= a + b;
+            const bool right = (p >= a && p < a + b) || p >= a + b + c;
+            from = (from << 1) | (down ? 1 : 0);
+            to = (to << 1) | (right ? 1 : 0);
+        }
+        return Arc{from, to, scaleWeight(stream.unit(), options)};
+    });
+}
+
+template<class W>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::kronecker(unsigned scale, size_t edgeFactor,
+                                                                          const GeneratorOptions &options) {
+    std::vector<Arc> arcs = rmat(scale, edgeFactor << scale, options);
+    if (scale == 0) return arcs;
+
+    // odd multipliers and xor-shifts are bijections of [0, 2^scale), so is their composition
+    const uint64_t mask = (uint64_t(1) << scale) - 1;
+    Stream keys(options.seed, ~uint64_t(0));
+    const uint64_t first = keys.next() | 1, second = keys.next() | 1;
+    const unsigned shift = (scale + 1) / 2;
+    auto scramble = [&](uint64_t v) {
+        v = (v * first) & mask;
+        v ^= v >> shift;
+        v = (v * second) & mask;
+        return (VertexId) (v ^ (v >> shift));
+    };
+
+    ParallelOptions parallel;
+    parallel.threads = options.threads;
+    ThreadPool::global().parallelFor(0, arcs.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            arcs[i].from = scramble(arcs[i].from);
+            arcs[i].to = scramble(arcs[i].to);
+        }
+    }, parallel);
+    return arcs;
+}
+
+template<class W>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::erdosRenyi(size_t vertices, size_t edges,
+                                                                           const GeneratorOptions &options) {
+    checkVertices(vertices);
+    return generate(edges, options, [&](size_t, Stream &stream) {
+        const VertexId from = (VertexId) stream.below(vertices);
+        const VertexId to = (VertexId) stream.below(vertices);
+        return Arc{from, to, scaleWeight(stream.unit(), options)};
+    });
+}
+
+template<class W>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::grid(size_t rows, size_t columns,
+                                                                     const GeneratorOptions &options) {
+    checkVertices(rows * columns);
+
+    // every row but the last holds (columns - 1) right arcs and columns down arcs, interleaved
+    const size_t perRow = 2 * columns - 1;
+    const size_t count = (rows - 1) * perRow + (columns - 1);
+    return generate(count, options, [&](size_t i, Stream &stream) {
+        const size_t r = i / perRow, offset = i % perRow;
+        const bool lastRow = r + 1 == rows;
+        const size_t c = lastRow ? offset : offset / 2;
+        const bool down = !lastRow && (offset % 2 == 1 || c + 1 == columns);
+
+        const VertexId v = (VertexId) (r * columns + c);
+        return Arc{v, (VertexId) (down ? v + columns : v + 1), scaleWeight(stream.unit(), options)};
+    });
+}
+
+template<class W>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::powerLaw(size_t vertices, size_t edges,
+                                                                         const GeneratorOptions &options,
+                                                                         double exponent) {
+    checkVertices(vertices);
+
+    // vertex weight (x + 1)^-gamma, cumulative weight F(x) = ((x + 1)^(1 - gamma) - 1) / (1 - gamma)
+    const double gamma = 1.0 / (exponent - 1.0);
+    const bool logarithmic = std::abs(1.0 - gamma) < 1e-9;
+    const double top = logarithmic ? std::log((double) vertices + 1) : std::pow((double) vertices + 1, 1.0 - gamma) - 1;
+    auto endpoint = [&](double unit) {
+        const double x = logarithmic ? std::exp(unit * top) - 1 : std::pow(1 + unit * top, 1.0 / (1.0 - gamma)) - 1;
+        return (VertexId) std::min<double>(std::floor(x), (double) (vertices - 1));
+    };
+
+    return generate(edges, options, [&](size_t, Stream &stream) {
+        const VertexId from = endpoint(stream.unit());
+        const VertexId to = endpoint(stream.unit());
+        return Arc{from, to, scaleWeight(stream.unit(), options)};
+    });
+}
+
+template<class W>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::barabasiAlbert(size_t vertices, size_t m,
+                                                                               const GeneratorOptions &options) {
+    checkVertices(vertices);
+
+    // endpoint list: position 2i holds the origin of arc i (i / m), position 2i + 1 copies a
+    // uniformly drawn position in [0, 2i]; copies are followed back until an origin is reached
+    return generate(vertices * m, options, [&](size_t i, Stream &stream) {
+        uint64_t position = stream.below(2 * i + 1);
+        while (position % 2 == 1) {
+            Stream earlier(options.seed, position / 2);
+            position = earlier.below(position);
+        }
+        return Arc{(VertexId) (i / m), (VertexId) (position / 2 / m), scaleWeight(stream.unit(), options)};
+    });
+}
+
+template<class W>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::wattsStrogatz(size_t vertices, size_t k, double beta,
+                                                                              const GeneratorOptions &options) {
+    checkVertices(vertices);
+    const size_t half = std::max<size_t>(1, k / 2);
+
+    return generate(vertices * half, options, [&](size_t i, Stream &stream) {
+        const size_t v = i / half, step = i % half + 1;
+        VertexId to = (VertexId) ((v + step) % vertices);
+        if (vertices > 1 && stream.unit() < beta)
+            to = (VertexId) ((v + 1 + stream.below(vertices - 1)) % vertices);
+        return Arc{(VertexId) v, to, scaleWeight(stream.unit(), options)};
+    });
+}
+
+template<class W>
+std::vector<typename GraphGenerator<W>::Arc> GraphGenerator<W>::randomGeometric(size_t vertices, double radius,
+                                                                                const GeneratorOptions &options) {
+    checkVertices(vertices);
+    ParallelOptions parallel;
+    parallel.threads = options.threads;
+    ThreadPool &pool = ThreadPool::global();
+
+    std::vector<double> x(vertices), y(vertices);
+    pool.parallelFor(0, vertices, [&](size_t first, size_t last) {
+        for (size_t v = first; v < last; v++) {
+            Stream stream(options.seed, v);
+            x[v] = stream.unit();
+            y[v] = stream.unit();
+        }
+    }, parallel);
+
+    // bucket the points by cell with a counting sort, cells are at least radius wide
+    const size_t side = radius > 0 ? std::max<size_t>(1, (size_t) std::min(1.0 / radius, 32768.0)) : 1;
+    auto cellOf = [&](size_t v) {
+        return std::min(side - 1, (size_t) (y[v] * side)) * side + std::min(side - 1, (size_t) (x[v] * side));
+    };
+    std::vector<size_t> cellStart(side * side + 1, 0);
+    for (size_t v = 0; v < vertices; v++) cellStart[cellOf(v) + 1]++;
+    for (size_t c = 0; c < side * side; c++) cellStart[c + 1] += cellStart[c];
+    std::vector<VertexId> byCell(vertices);
+    std::vector<size_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t v = 0; v < vertices; v++) byCell[fill[cellOf(v)]++] = (VertexId) v;
+
+    // every neighbour u > v of v within the radius, in cell then id order
+    const double squared = radius * radius;
+    auto forNeighbours = [&](size_t v, auto visit) {
+        const size_t cell = cellOf(v), row = cell / side, column = cell % side;
+        for (size_t r = row == 0 ? 0 : row - 1; r <= std::min(side - 1, row + 1); r++) {
+            for (size_t c = column == 0 ? 0 : column - 1; c <= std::min(side - 1, column + 1); c++) {
+                for (size_t slot = cellStart[r * side + c]; slot < cellStart[r * side + c + 1]; slot++) {
+                    const VertexId u = byCell[slot];
+                    const double dx = x[u] - x[v], dy = y[u] - y[v];
+                    const double distance = dx * dx + dy * dy;
+                    if (u > v && distance <= squared) visit(u, std::sqrt(distance));
+                }
+            }
+        }
+    };
+
+    // two passes (count, prefix sum, fill) keep the arc order independent of the thread count
+    std::vector<size_t> offsets(vertices + 1, 0);
+    pool.parallelFor(0, vertices, [&](size_t first, size_t last) {
+        for (size_t v = first; v < last; v++) forNeighbours(v, [&](VertexId, double) { offsets[v + 1]++; });
+    }, parallel);
+    for (size_t v = 0; v < vertices; v++) offsets[v + 1] += offsets[v];
+
+    std::vector<Arc> arcs(offsets[vertices]);
+    pool.parallelFor(0, vertices, [&](size_t first, size_t last) {
+        for (size_t v = first; v < last; v++) {
+            size_t next = offsets[v];
+            forNeighbours(v, [&](VertexId u, double distance) {
+                arcs[next++] = Arc{(VertexId) v, u, scaleWeight(radius > 0 ? distance / radius : 0, options)};
+            });
+        }
+    }, parallel);
+    return arcs;
+}
+
+#endif //GRAPHALGORITHM_GRAPHGENERATOR_HPP
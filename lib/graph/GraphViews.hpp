@@ -0,0 +1,163 @@
+#ifndef GRAPHALGORITHM_GRAPHVIEWS_HPP
+#define GRAPHALGORITHM_GRAPHVIEWS_HPP
+
+#include <cstddef>
+#include <iterator>
+
+/**
+ * Read-only view of the vertices of a graph, i.e. the keys of its adjacency map.
+ *
+ * Costs two pointers and copies nothing. It offers the read side of std::unordered_set
+ * (iteration, size, find, count, contains) so code written against a vertex set keeps working.
+ * Like any view it is invalidated by adding or removing vertices.
+ *
+ * @tparam Map the adjacency map type, vertex -> edge set
+ */
+template<class Map>
+class VertexView {
+    const Map *adjacency;
+
+public:
+    using key_type = typename Map::key_type;
+    using value_type = typename Map::key_type;
+
+    class const_iterator {
+        typename Map::const_iterator position;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Map::key_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        const_iterator() = default;
+        explicit const_iterator(typename Map::const_iterator position) : position(position) {}
+
+        reference operator*() const { return position->first; }
+        pointer operator->() const { return &position->first; }
+
+        const_iterator &operator++() {
+            ++position;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++position;
+            return copy;
+        }
+
+        bool operator==(const const_iterator &rhs) const { return position == rhs.position; }
+        bool operator!=(const const_iterator &rhs) const { return position != rhs.position; }
+    };
+
+    using iterator = const_iterator;
+
+    explicit VertexView(const Map &adjacency) : adjacency(&adjacency) {}
+
+    const_iterator begin() const { return const_iterator(adjacency->begin()); }
+    const_iterator end() const { return const_iterator(adjacency->end()); }
+    size_t size() const { return adjacency->size(); }
+    bool empty() const { return adjacency->empty(); }
+    const_iterator find(const key_type &vertex) const { return const_iterator(adjacency->find(vertex)); }
+    size_t count(const key_type &vertex) const { return adjacency->count(vertex); }
+    bool contains(const key_type &vertex) const { return adjacency->find(vertex) != adjacency->end(); }
+};
+
+/**
+ * Read-only view of every edge of a graph, walking the adjacency sets one after the other.
+ *
+ * In an undirected graph both (u, v) and (v, u) are visited. size() is O(1) because the
+ * graph keeps an edge counter, and find/count/contains look in the adjacency set of the
+ * edge origin only.
+ *
+ * @tparam Map the adjacency map type, vertex -> edge set
+ */
+template<class Map>
+class EdgeView {
+    using EdgeSet = typename Map::mapped_type;
+
+    const Map *adjacency;
+    size_t edgeCount;
+
+public:
+    using value_type = typename EdgeSet::value_type;
+    using key_type = typename EdgeSet::value_type;
+
+    class const_iterator {
+        typename Map::const_iterator vertex;
+        typename Map::const_iterator last;
+        typename EdgeSet::const_iterator edge;
+
+        void skipEmpty() {
+            while (vertex != last && edge == vertex->second.end()) {
+                if (++vertex != last) edge = vertex->second.begin();
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename EdgeSet::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        const_iterator() = default;
+
+        const_iterator(typename Map::const_iterator vertex, typename Map::const_iterator last)
+                : vertex(vertex), last(last) {
+            if (vertex != last) {
+                edge = vertex->second.begin();
+                skipEmpty();
+            }
+        }
+
+        const_iterator(typename Map::const_iterator vertex, typename Map::const_iterator last,
+                       typename EdgeSet::const_iterator edge) : vertex(vertex), last(last), edge(edge) {}
+
+        reference operator*() const { return *edge; }
+        pointer operator->() const { return &*edge; }
+
+        const_iterator &operator++() {
+            ++edge;
+            skipEmpty();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return vertex == rhs.vertex && (vertex == last || edge == rhs.edge);
+        }
+
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    };
+
+    using iterator = const_iterator;
+
+    EdgeView(const Map &adjacency, size_t edgeCount) : adjacency(&adjacency), edgeCount(edgeCount) {}
+
+    const_iterator begin() const { return const_iterator(adjacency->begin(), adjacency->end()); }
+    const_iterator end() const { return const_iterator(adjacency->end(), adjacency->end()); }
+    size_t size() const { return edgeCount; }
+    bool empty() const { return edgeCount == 0; }
+
+    const_iterator find(const value_type &edge) const {
+        auto vertex = adjacency->find(edge.getFrom());
+        if (vertex == adjacency->end()) return end();
+
+        auto found = vertex->second.find(edge);
+        if (found == vertex->second.end()) return end();
+        return const_iterator(vertex, adjacency->end(), found);
+    }
+
+    size_t count(const value_type &edge) const { return find(edge) != end() ? 1 : 0; }
+    bool contains(const value_type &edge) const { return find(edge) != end(); }
+};
+
+#endif //GRAPHALGORITHM_GRAPHVIEWS_HPP
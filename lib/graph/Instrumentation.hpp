@@ -0,0 +1,193 @@
+#ifndef GRAPHALGORITHM_INSTRUMENTATION_HPP
+#define GRAPHALGORITHM_INSTRUMENTATION_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Compile-time switch of the query counters and timers, off by default. Configure with
+ * -DGRAPHALGORITHM_INSTRUMENTATION=ON (or define the macro to 1) to turn them on; when off every
+ * recording call is an empty inline function and the searches compile to the same code as before.
+ */
+#ifndef GRAPHALGORITHM_INSTRUMENTATION
+#define GRAPHALGORITHM_INSTRUMENTATION 0
+#endif
+
+/**
+ * What a single query (a dijkstra, prim, breadthFirstSearch... call) did and where its time went.
+ */
+struct QueryStats {
+    /**
+     * Phases of a query: clearing and initializing the scratch state, the search loop itself,
+     * and writing the result out (the tree of prim).
+     */
+    enum Phase { SETUP, SEARCH, OUTPUT, PHASE_COUNT };
+
+    uint64_t verticesSettled = 0;
+    uint64_t edgesScanned = 0;
+
+    /**
+     * Heap traffic of the weighted searches; for BFS and DFS, pushes on the frontier (queue or
+     * stack of the current path) and its largest size.
+     */
+    uint64_t heapPushes = 0;
+    uint64_t heapPops = 0;
+
+    /**
+     * Pops of a vertex that was already settled (lazy deletion leftovers).
+     */
+    uint64_t stalePops = 0;
+    uint64_t peakHeapSize = 0;
+
+    /**
+     * Calls to Graph::getAdjacent and the keys compared in the hash buckets they walked;
+     * probes / lookups close to 1 means the vertex hash spreads well.
+     */
+    uint64_t adjacencyLookups = 0;
+    uint64_t hashProbes = 0;
+
+    std::chrono::nanoseconds phaseTime[PHASE_COUNT] = {};
+
+    /**
+     * @return The sum of the phase times.
+     */
+    std::chrono::nanoseconds totalTime() const {
+        std::chrono::nanoseconds total{0};
+        for (const auto &time : phaseTime) total += time;
+        return total;
+    }
+};
+
+/**
+ * Records the QueryStats of the queries run by one algorithm object.
+ *
+ * A query opens a scope(); while it is open the recorder is the current one of its thread, which
+ * is how Graph::getAdjacent finds where to count its probes. Only the Enabled = true
+ * specialization records anything.
+ *
+ * @tparam Enabled Whether the counters exist at all, see GRAPHALGORITHM_INSTRUMENTATION.
+ */
+template<bool Enabled>
+class QueryRecorder;
+
+template<>
+class QueryRecorder<true> {
+    using Clock = std::chrono::steady_clock;
+
+    QueryStats stats;
+    QueryStats::Phase current = QueryStats::SETUP;
+    Clock::time_point started;
+
+    static QueryStats *&active() {
+        static thread_local QueryStats *stats = nullptr;
+        return stats;
+    }
+
+public:
+    static constexpr bool ENABLED = true;
+
+    /**
+     * Closes the query when it goes out of scope, also when the query throws.
+     */
+    class Scope {
+        QueryRecorder *recorder;
+        QueryStats *outer;
+
+    public:
+        explicit Scope(QueryRecorder *recorder) : recorder(recorder), outer(active()) {
+            recorder->stats = QueryStats();
+            recorder->current = QueryStats::SETUP;
+            recorder->started = Clock::now();
+            active() = &recorder->stats;
+        }
+
+        ~Scope() {
+            recorder->phase(QueryStats::SETUP);
+            active() = outer;
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    /**
+     * @brief Starts a query: resets the stats and starts timing its SETUP phase.
+     */
+    Scope scope() { return Scope(this); }
+
+    /**
+     * @brief Charges the time since the last phase change to the running phase and switches to next.
+     */
+    void phase(QueryStats::Phase next) {
+        const Clock::time_point now = Clock::now();
+        stats.phaseTime[current] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - started);
+        started = now;
+        current = next;
+    }
+
+    void settled() { stats.verticesSettled++; }
+    void scanned() { stats.edgesScanned++; }
+    void popped() { stats.heapPops++; }
+    void stale() { stats.stalePops++; }
+
+    void pushed(size_t heapSize) {
+        stats.heapPushes++;
+        if (heapSize > stats.peakHeapSize) stats.peakHeapSize = heapSize;
+    }
+
+    /**
+     * @brief Counts a lookup of key in a node-based hash map, for the query running on this thread.
+     */
+    template<class Map, class Key>
+    static void probed(const Map &map, const Key &key) {
+        QueryStats *stats = active();
+        if (stats == nullptr) return;
+
+        stats->adjacencyLookups++;
+        if (map.bucket_count() == 0) return;
+        const size_t bucket = map.bucket(key);
+        for (auto it = map.begin(bucket); it != map.end(bucket); ++it) {
+            stats->hashProbes++;
+            if (map.key_eq()(it->first, key)) break;
+        }
+    }
+
+    /**
+     * @return The stats of the last query.
+     */
+    const QueryStats &getStats() const { return stats; }
+};
+
+template<>
+class QueryRecorder<false> {
+public:
+    static constexpr bool ENABLED = false;
+
+    struct Scope {
+        ~Scope() {}
+    };
+
+    Scope scope() { return {}; }
+    void phase(QueryStats::Phase) {}
+    void settled() {}
+    void scanned() {}
+    void popped() {}
+    void stale() {}
+    void pushed(size_t) {}
+
+    template<class Map, class Key>
+    static void probed(const Map &, const Key &) {}
+
+    /**
+     * @return All zero: instrumentation is compiled out.
+     */
+    const QueryStats &getStats() const {
+        static const QueryStats none;
+        return none;
+    }
+};
+
+using Instrumentation = QueryRecorder<GRAPHALGORITHM_INSTRUMENTATION != 0>;
+
+#endif //GRAPHALGORITHM_INSTRUMENTATION_HPP
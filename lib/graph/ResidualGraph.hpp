@@ -0,0 +1,224 @@
+#ifndef GRAPHALGORITHM_RESIDUALGRAPH_HPP
+#define GRAPHALGORITHM_RESIDUALGRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "MemoryUsage.hpp"
+
+/**
+ * The residual network of a flow problem, in CSR layout.
+ *
+ * Every input edge (u, v) with capacity c becomes two paired arcs: a forward arc u -> v in the
+ * slots of u and a reverse arc v -> u in the slots of v, each knowing the id of the other.
+ * Pushing f units along an arc takes f from its residual capacity and gives it to its pair, so
+ * the flow of an edge is the residual capacity of its reverse arc. Vertices are dense ids in
+ * [0, getVertexCount()), like in CsrGraph.
+ *
+ * For min-cost flow problems arcs also carry a cost per unit of flow, negated on reverse arcs:
+ * sending flow back along an edge refunds its cost.
+ *
+ * @tparam F capacity and flow type
+ * @tparam C cost type, signed
+ */
+template<class F = double, class C = F>
+class ResidualGraph {
+public:
+    using VertexId = uint32_t;
+    using ArcId = uint64_t;
+
+    /**
+     * An input edge, its capacity and its cost per unit of flow.
+     */
+    struct Arc {
+        VertexId from;
+        VertexId to;
+        F capacity;
+        C cost = C(0);
+    };
+
+private:
+    std::vector<ArcId> offsets{0};
+    std::vector<VertexId> heads;
+    std::vector<ArcId> reverses;
+    std::vector<F> residuals;
+    std::vector<C> costs;
+
+    // per input edge, in input order
+    std::vector<ArcId> edgeArcs;
+    std::vector<F> capacities;
+
+public:
+    ResidualGraph() = default;
+
+    /**
+     * @brief Packs the edges, forward and reverse arcs together, with a counting sort by tail.
+     *
+     * Edges keep their input index: getFlow(i) is the flow of arcs[i].
+     *
+     * @param withCosts True to keep the arc costs, which getCost needs; without, they take no memory.
+     * @throw std::invalid_argument If a capacity is negative.
+     */
+    static ResidualGraph<F, C> fromArcs(size_t vertexCount, const std::vector<Arc> &arcs, bool withCosts = false);
+
+    /**
+     * @brief Gives every edge back its full capacity: zero flow.
+     */
+    void reset();
+
+    size_t getVertexCount() const;
+
+    /**
+     * @return The number of arcs, twice the number of edges.
+     */
+    size_t getArcCount() const;
+    size_t getEdgeCount() const;
+
+    ArcId arcBegin(VertexId v) const { return offsets[v]; }
+    ArcId arcEnd(VertexId v) const { return offsets[v + 1]; }
+    VertexId getHead(ArcId a) const { return heads[a]; }
+
+    /**
+     * @return The arc paired with a, going the other way.
+     */
+    ArcId getReverse(ArcId a) const { return reverses[a]; }
+    F getResidual(ArcId a) const { return residuals[a]; }
+
+    /**
+     * @return The cost of a unit of flow along a, when built with costs.
+     */
+    C getCost(ArcId a) const { return costs[a]; }
+
+    /**
+     * @brief Sends amount units along a, which must have that much residual capacity.
+     */
+    void push(ArcId a, F amount) {
+        residuals[a] -= amount;
+        residuals[reverses[a]] += amount;
+    }
+
+    /**
+     * @return The forward arc of input edge i.
+     */
+    ArcId getEdgeArc(size_t i) const;
+    F getCapacity(size_t i) const;
+
+    /**
+     * @brief Changes the capacity of input edge i and removes its flow.
+     */
+    void setCapacity(size_t i, F capacity);
+
+    /**
+     * @return The flow on input edge i.
+     */
+    F getFlow(size_t i) const;
+
+    /**
+     * @return The bytes of the arc and edge arrays.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+template<class F, class C>
+ResidualGraph<F, C> ResidualGraph<F, C>::fromArcs(size_t vertexCount, const std::vector<Arc> &arcs, bool withCosts) {
+    ResidualGraph<F, C> residual;
+    residual.offsets.assign(vertexCount + 1, 0);
+    for (const Arc &arc : arcs) {
+        if (arc.capacity < F(0)) throw std::invalid_argument("ResidualGraph: negative capacity");
+        residual.offsets[arc.from + 1]++;
+        residual.offsets[arc.to + 1]++;
+    }
+
+    for (size_t v = 0; v < vertexCount; v++)
+        residual.offsets[v + 1] += residual.offsets[v];
+
+    const size_t arcCount = residual.offsets[vertexCount];
+    residual.heads.resize(arcCount);
+    residual.reverses.resize(arcCount);
+    residual.residuals.resize(arcCount);
+    if (withCosts) residual.costs.resize(arcCount);
+    residual.edgeArcs.resize(arcs.size());
+    residual.capacities.resize(arcs.size());
+
+    std::vector<ArcId> cursor(residual.offsets.begin(), residual.offsets.end() - 1);
+    for (size_t i = 0; i < arcs.size(); i++) {
+        const Arc &arc = arcs[i];
+        const ArcId forward = cursor[arc.from]++;
+        const ArcId backward = cursor[arc.to]++;
+        residual.heads[forward] = arc.to;
+        residual.heads[backward] = arc.from;
+        residual.reverses[forward] = backward;
+        residual.reverses[backward] = forward;
+        residual.edgeArcs[i] = forward;
+        residual.capacities[i] = arc.capacity;
+        if (withCosts) {
+            residual.costs[forward] = arc.cost;
+            residual.costs[backward] = -arc.cost;
+        }
+    }
+
+    residual.reset();
+    return residual;
+}
+
+template<class F, class C>
+void ResidualGraph<F, C>::reset() {
+    for (size_t i = 0; i < edgeArcs.size(); i++) {
+        residuals[edgeArcs[i]] = capacities[i];
+        residuals[reverses[edgeArcs[i]]] = F(0);
+    }
+}
+
+template<class F, class C>
+size_t ResidualGraph<F, C>::getVertexCount() const {
+    return offsets.size() - 1;
+}
+
+template<class F, class C>
+size_t ResidualGraph<F, C>::getArcCount() const {
+    return heads.size();
+}
+
+template<class F, class C>
+size_t ResidualGraph<F, C>::getEdgeCount() const {
+    return edgeArcs.size();
+}
+
+template<class F, class C>
+typename ResidualGraph<F, C>::ArcId ResidualGraph<F, C>::getEdgeArc(size_t i) const {
+    return edgeArcs[i];
+}
+
+template<class F, class C>
+F ResidualGraph<F, C>::getCapacity(size_t i) const {
+    return capacities[i];
+}
+
+template<class F, class C>
+void ResidualGraph<F, C>::setCapacity(size_t i, F capacity) {
+    if (capacity < F(0)) throw std::invalid_argument("ResidualGraph: negative capacity");
+    capacities[i] = capacity;
+    residuals[edgeArcs[i]] = capacity;
+    residuals[reverses[edgeArcs[i]]] = F(0);
+}
+
+template<class F, class C>
+F ResidualGraph<F, C>::getFlow(size_t i) const {
+    return residuals[reverses[edgeArcs[i]]];
+}
+
+template<class F, class C>
+MemoryUsage ResidualGraph<F, C>::memoryUsage() const {
+    MemoryUsage usage = MemoryUsage::of(offsets);
+    usage += MemoryUsage::of(heads);
+    usage += MemoryUsage::of(reverses);
+    usage += MemoryUsage::of(residuals);
+    usage += MemoryUsage::of(costs);
+    usage += MemoryUsage::of(edgeArcs);
+    usage += MemoryUsage::of(capacities);
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_RESIDUALGRAPH_HPP
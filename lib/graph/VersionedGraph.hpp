@@ -0,0 +1,542 @@
+#ifndef GRAPHALGORITHM_VERSIONEDGRAPH_HPP
+#define GRAPHALGORITHM_VERSIONEDGRAPH_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Edge.hpp"
+#include "FlatHashSet.hpp"
+
+/**
+ * A graph shared by one writer and any number of readers, with snapshot isolation.
+ *
+ * Every published state is an immutable version. The vertices are spread over SHARDS hash
+ * shards and every adjacency set lives in its own block; versions share shards and blocks
+ * through reference counting, and the writer copies a shard or a block only the first time
+ * a batch touches it (copy-on-write). Writes are invisible until publish(), which swaps the
+ * whole batch in with a single atomic store.
+ *
+ * Readers call snapshot() and traverse the returned handle without taking any lock: it pins
+ * the version that was current at that moment, and later batches never modify it. Replaced
+ * versions are reclaimed by the writer through epoch-based reclamation, once no snapshot taken
+ * before their replacement is alive.
+ *
+ * The writer methods (addVertex, addEdge, removeEdge, removeVertex, publish, reclaim) must not
+ * be called concurrently with each other; snapshot() and everything on a Snapshot may be
+ * called from any thread. A snapshot must not outlive its VersionedGraph.
+ *
+ * @tparam T data type holder by vertex
+ * @tparam W weight type of the edges
+ */
+template<class T, class W = double>
+class VersionedGraph {
+public:
+    using EdgeSet = FlatHashSet<Edge<T, W>>;
+
+    /**
+     * Maximum number of snapshots alive at the same time.
+     */
+    static constexpr size_t MAX_READERS = 128;
+
+private:
+    static constexpr unsigned SHARD_BITS = 6;
+    static constexpr size_t SHARDS = size_t(1) << SHARD_BITS;
+    static constexpr uint64_t IDLE = std::numeric_limits<uint64_t>::max();
+
+    using Shard = std::unordered_map<T, std::shared_ptr<EdgeSet>>;
+
+    struct Version {
+        std::array<std::shared_ptr<Shard>, SHARDS> shards;
+        size_t vertexCount = 0;
+        size_t edgeCount = 0;
+        uint64_t number = 0;
+    };
+
+    // one cache line per reader so that pinning does not bounce the lines of other readers
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{IDLE};
+    };
+
+    bool directed;
+    std::atomic<const Version *> current;
+    std::atomic<uint64_t> globalEpoch{1};
+    mutable std::array<ReaderSlot, MAX_READERS> readers;
+
+    // writer state
+    std::unique_ptr<Version> pending;
+    std::vector<std::pair<uint64_t, const Version *>> retired;
+
+    static size_t shardOf(const T &vertex);
+
+    Version &working();
+    Shard &writableShard(size_t shard);
+    EdgeSet &writableBlock(const T &vertex);
+    void edgeTo(const T &from, const T &to, W weight);
+    size_t eraseEdge(const T &from, const T &to);
+
+public:
+    class Snapshot;
+
+    /**
+     * Read-only view of the vertices of a snapshot (iterable, size, find, count, contains).
+     */
+    class VertexView {
+        const Version *version;
+
+    public:
+        class const_iterator {
+            const Version *version = nullptr;
+            size_t shard = SHARDS;
+            typename Shard::const_iterator position;
+
+            void skipEmpty() {
+                while (shard < SHARDS && position == version->shards[shard]->end()) {
+                    if (++shard < SHARDS) position = version->shards[shard]->begin();
+                }
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T *;
+            using reference = const T &;
+
+            const_iterator() = default;
+
+            const_iterator(const Version *version, size_t shard) : version(version), shard(shard) {
+                if (shard < SHARDS) {
+                    position = version->shards[shard]->begin();
+                    skipEmpty();
+                }
+            }
+
+            const_iterator(const Version *version, size_t shard, typename Shard::const_iterator position)
+                    : version(version), shard(shard), position(position) {}
+
+            reference operator*() const { return position->first; }
+            pointer operator->() const { return &position->first; }
+
+            const_iterator &operator++() {
+                ++position;
+                skipEmpty();
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return shard == rhs.shard && (shard == SHARDS || position == rhs.position);
+            }
+
+            bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+        };
+
+        using iterator = const_iterator;
+        using value_type = T;
+
+        explicit VertexView(const Version *version) : version(version) {}
+
+        const_iterator begin() const { return const_iterator(version, 0); }
+        const_iterator end() const { return const_iterator(version, SHARDS); }
+        size_t size() const { return version->vertexCount; }
+        bool empty() const { return version->vertexCount == 0; }
+
+        const_iterator find(const T &vertex) const {
+            const size_t shard = shardOf(vertex);
+            auto it = version->shards[shard]->find(vertex);
+            return it == version->shards[shard]->end() ? end() : const_iterator(version, shard, it);
+        }
+
+        size_t count(const T &vertex) const { return contains(vertex) ? 1 : 0; }
+        bool contains(const T &vertex) const { return version->shards[shardOf(vertex)]->count(vertex) != 0; }
+    };
+
+    /**
+     * A pinned, immutable version of the graph. Movable, not copyable; the version stays
+     * readable until the handle is destroyed.
+     *
+     * It offers the read side of Graph (operator[], getAdjacent, getVertices, isEmpty, isDirected)
+     * so it can be searched by GraphAlgorithm<T, W, Snapshot>.
+     */
+    class Snapshot {
+        const VersionedGraph *owner = nullptr;
+        size_t slot = 0;
+        const Version *version = nullptr;
+
+        friend class VersionedGraph;
+
+        Snapshot(const VersionedGraph *owner, size_t slot, const Version *version)
+                : owner(owner), slot(slot), version(version) {}
+
+        void release();
+
+    public:
+        Snapshot(Snapshot &&other) noexcept;
+        Snapshot &operator=(Snapshot &&other) noexcept;
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+        ~Snapshot();
+
+        /**
+         * @return The number of the pinned version, incremented by every publish().
+         */
+        uint64_t getVersion() const;
+
+        /**
+         * @brief Find all vertices adjacent to the given value
+         *
+         * @param data The vertex to be find
+         * @return Read-only set with all adjacent of data, empty if the vertex does not exist
+         */
+        const EdgeSet &getAdjacent(const T &data) const;
+
+        /**
+         * @brief Same as getAdjacent.
+         */
+        const EdgeSet &operator[](const T &data) const;
+
+        /**
+         * @return A read-only view of all vertices in the snapshot
+         */
+        VertexView getVertices() const;
+
+        /**
+         * @return The number of edges; in an undirected graph, both (u, v) and (v, u) are counted.
+         */
+        size_t getEdgeCount() const;
+
+        /**
+         * @return True if the snapshot contains no vertex.
+         */
+        bool isEmpty() const;
+
+        /**
+         * @return True if edges are one-way.
+         */
+        bool isDirected() const;
+    };
+
+    /**
+     * @param directed Whether addEdge stores one-way edges (as Digraph) or both directions (as Graph).
+     */
+    explicit VersionedGraph(bool directed = false);
+    ~VersionedGraph();
+
+    VersionedGraph(const VersionedGraph &) = delete;
+    VersionedGraph &operator=(const VersionedGraph &) = delete;
+
+    /**
+     * @brief Pins the latest published version for reading. Lock-free.
+     *
+     * @return A handle on the version; it keeps that version alive until destroyed.
+     * @throw std::runtime_error If MAX_READERS snapshots are already alive.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Adds a vertex to the pending batch if there isn't one with same hash and '==' (operator).
+     */
+    void addVertex(const T &vertex);
+
+    /**
+     * @brief Adds an edge to the pending batch, in both directions unless the graph is directed.
+     *
+     * @param from The origin vertex.
+     * @param to The destination vertex linked from the origin (from)
+     * @param weight The weight of the edge.
+     */
+    void addEdge(const T &from, const T &to, W weight);
+
+    /**
+     * @brief Removes an edge (and its mirror in an undirected graph) in the pending batch.
+     *
+     * @return True if the edge existed.
+     */
+    bool removeEdge(const T &from, const T &to);
+
+    /**
+     * @brief Removes a vertex and all edges associated with it in the pending batch.
+     *
+     * @note O(degree) in an undirected graph, O(V) in a directed one (incoming edges are looked up
+     * in every shard).
+     * @return True if the vertex existed.
+     */
+    bool removeVertex(const T &vertex);
+
+    /**
+     * @brief Atomically makes every change made since the last publish visible to new snapshots,
+     * then reclaims the versions no snapshot can see anymore.
+     *
+     * @return The number of the now current version.
+     */
+    uint64_t publish();
+
+    /**
+     * @brief Drops the pending batch.
+     */
+    void discard();
+
+    /**
+     * @brief Frees the replaced versions that no live snapshot can reference. Called by publish().
+     *
+     * @return The number of versions still waiting for old snapshots to be released.
+     */
+    size_t reclaim();
+
+    /**
+     * @return True if edges are one-way.
+     */
+    bool isDirected() const;
+};
+
+template<class T, class W>
+size_t VersionedGraph<T, W>::shardOf(const T &vertex) {
+    uint64_t x = std::hash<T>()(vertex);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<size_t>((x ^ (x >> 31)) >> (64 - SHARD_BITS));
+}
+
+template<class T, class W>
+VersionedGraph<T, W>::VersionedGraph(bool directed) : directed(directed) {
+    auto *first = new Version();
+    for (auto &shard : first->shards) shard = std::make_shared<Shard>();
+    current.store(first);
+}
+
+template<class T, class W>
+VersionedGraph<T, W>::~VersionedGraph() {
+    for (const auto &[epoch, version] : retired) delete version;
+    delete current.load();
+}
+
+template<class T, class W>
+typename VersionedGraph<T, W>::Snapshot VersionedGraph<T, W>::snapshot() const {
+    for (size_t i = 0; i < MAX_READERS; i++) {
+        uint64_t idle = IDLE;
+        if (readers[i].epoch.load(std::memory_order_relaxed) != IDLE) continue;
+
+        // publish the epoch before reading the version: a writer that misses the pin has
+        // already swapped the version, so the load below returns the new one
+        if (readers[i].epoch.compare_exchange_strong(idle, globalEpoch.load()))
+            return Snapshot(this, i, current.load());
+    }
+    throw std::runtime_error("VersionedGraph: too many live snapshots");
+}
+
+template<class T, class W>
+typename VersionedGraph<T, W>::Version &VersionedGraph<T, W>::working() {
+    if (!pending) {
+        pending = std::make_unique<Version>(*current.load(std::memory_order_relaxed));
+        pending->number++;
+    }
+    return *pending;
+}
+
+template<class T, class W>
+typename VersionedGraph<T, W>::Shard &VersionedGraph<T, W>::writableShard(size_t shard) {
+    // only the writer touches the reference counts, so use_count() is exact: 1 means the
+    // shard belongs to the pending batch alone and can be modified in place
+    auto &pointer = working().shards[shard];
+    if (pointer.use_count() > 1) pointer = std::make_shared<Shard>(*pointer);
+    return *pointer;
+}
+
+template<class T, class W>
+typename VersionedGraph<T, W>::EdgeSet &VersionedGraph<T, W>::writableBlock(const T &vertex) {
+    Shard &shard = writableShard(shardOf(vertex));
+    auto [it, added] = shard.try_emplace(vertex);
+    if (added) {
+        it->second = std::make_shared<EdgeSet>();
+        pending->vertexCount++;
+    } else if (it->second.use_count() > 1) {
+        it->second = std::make_shared<EdgeSet>(*it->second);
+    }
+    return *it->second;
+}
+
+template<class T, class W>
+void VersionedGraph<T, W>::edgeTo(const T &from, const T &to, W weight) {
+    addVertex(to);
+    if (writableBlock(from).insert(Edge<T, W>(from, to, weight)).second)
+        pending->edgeCount++;
+}
+
+template<class T, class W>
+size_t VersionedGraph<T, W>::eraseEdge(const T &from, const T &to) {
+    const Shard &shard = *working().shards[shardOf(from)];
+    auto it = shard.find(from);
+    if (it == shard.end() || !it->second->contains(Edge<T, W>(from, to, 0))) return 0;
+
+    pending->edgeCount--;
+    return writableBlock(from).erase(Edge<T, W>(from, to, 0));
+}
+
+template<class T, class W>
+void VersionedGraph<T, W>::addVertex(const T &vertex) {
+    if (working().shards[shardOf(vertex)]->count(vertex) == 0)
+        writableBlock(vertex);
+}
+
+template<class T, class W>
+void VersionedGraph<T, W>::addEdge(const T &from, const T &to, W weight) {
+    edgeTo(from, to, weight);
+    if (!directed) edgeTo(to, from, weight);
+}
+
+template<class T, class W>
+bool VersionedGraph<T, W>::removeEdge(const T &from, const T &to) {
+    const bool removed = eraseEdge(from, to) != 0;
+    if (removed && !directed && !(from == to)) eraseEdge(to, from);
+    return removed;
+}
+
+template<class T, class W>
+bool VersionedGraph<T, W>::removeVertex(const T &vertex) {
+    const size_t index = shardOf(vertex);
+    const Shard &lookup = *working().shards[index];
+    auto found = lookup.find(vertex);
+    if (found == lookup.end()) return false;
+
+    // keep the block alive while its edges are walked, the shard entry is replaced below
+    std::shared_ptr<EdgeSet> outgoing = found->second;
+
+    if (directed) {
+        for (size_t shard = 0; shard < SHARDS; shard++) {
+            std::vector<T> sources;
+            for (const auto &[from, adjacent] : *pending->shards[shard])
+                if (!(from == vertex) && adjacent->contains(Edge<T, W>(from, vertex, 0))) sources.push_back(from);
+            for (const T &from : sources) eraseEdge(from, vertex);
+        }
+    } else {
+        for (const auto &edge : *outgoing)
+            if (!(edge.getTo() == vertex)) eraseEdge(edge.getTo(), vertex);
+    }
+
+    pending->edgeCount -= outgoing->size();
+    pending->vertexCount--;
+    writableShard(index).erase(vertex);
+    return true;
+}
+
+template<class T, class W>
+uint64_t VersionedGraph<T, W>::publish() {
+    if (!pending) return current.load(std::memory_order_relaxed)->number;
+
+    const Version *next = pending.release();
+    const Version *old = current.exchange(next);
+
+    // a snapshot pinned at this epoch or later was taken after the exchange and cannot see old
+    retired.emplace_back(globalEpoch.fetch_add(1) + 1, old);
+    reclaim();
+    return next->number;
+}
+
+template<class T, class W>
+void VersionedGraph<T, W>::discard() {
+    pending.reset();
+}
+
+template<class T, class W>
+size_t VersionedGraph<T, W>::reclaim() {
+    uint64_t oldest = IDLE;
+    for (const auto &reader : readers)
+        oldest = std::min(oldest, reader.epoch.load());
+
+    size_t kept = 0;
+    for (const auto &[epoch, version] : retired) {
+        if (epoch <= oldest) delete version;
+        else retired[kept++] = {epoch, version};
+    }
+    retired.resize(kept);
+    return kept;
+}
+
+template<class T, class W>
+bool VersionedGraph<T, W>::isDirected() const {
+    return directed;
+}
+
+template<class T, class W>
+void VersionedGraph<T, W>::Snapshot::release() {
+    if (owner == nullptr) return;
+    owner->readers[slot].epoch.store(IDLE, std::memory_order_release);
+    owner = nullptr;
+}
+
+template<class T, class W>
+VersionedGraph<T, W>::Snapshot::Snapshot(Snapshot &&other) noexcept
+        : owner(other.owner), slot(other.slot), version(other.version) {
+    other.owner = nullptr;
+}
+
+template<class T, class W>
+typename VersionedGraph<T, W>::Snapshot &VersionedGraph<T, W>::Snapshot::operator=(Snapshot &&other) noexcept {
+    if (this != &other) {
+        release();
+        owner = other.owner;
+        slot = other.slot;
+        version = other.version;
+        other.owner = nullptr;
+    }
+    return *this;
+}
+
+template<class T, class W>
+VersionedGraph<T, W>::Snapshot::~Snapshot() {
+    release();
+}
+
+template<class T, class W>
+uint64_t VersionedGraph<T, W>::Snapshot::getVersion() const {
+    return version->number;
+}
+
+template<class T, class W>
+const typename VersionedGraph<T, W>::EdgeSet &VersionedGraph<T, W>::Snapshot::getAdjacent(const T &data) const {
+    static const EdgeSet emptySet;
+    const Shard &shard = *version->shards[shardOf(data)];
+    auto it = shard.find(data);
+    return it != shard.end() ? *it->second : emptySet;
+}
+
+template<class T, class W>
+const typename VersionedGraph<T, W>::EdgeSet &VersionedGraph<T, W>::Snapshot::operator[](const T &data) const {
+    return getAdjacent(data);
+}
+
+template<class T, class W>
+typename VersionedGraph<T, W>::VertexView VersionedGraph<T, W>::Snapshot::getVertices() const {
+    return VertexView(version);
+}
+
+template<class T, class W>
+size_t VersionedGraph<T, W>::Snapshot::getEdgeCount() const {
+    return version->edgeCount;
+}
+
+template<class T, class W>
+bool VersionedGraph<T, W>::Snapshot::isEmpty() const {
+    return version->vertexCount == 0;
+}
+
+template<class T, class W>
+bool VersionedGraph<T, W>::Snapshot::isDirected() const {
+    return owner != nullptr && owner->directed;
+}
+
+#endif //GRAPHALGORITHM_VERSIONEDGRAPH_HPP
@@ -0,0 +1,41 @@
+#ifndef GRAPHALGORITHM_WEIGHTTRAITS_HPP
+#define GRAPHALGORITHM_WEIGHTTRAITS_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * Types and constants derived from an edge weight type.
+ *
+ * Edges store the narrow weight W (2 or 4 bytes halve the edge bandwidth of a search), while path
+ * lengths accumulate in the wider Distance type: 64-bit integers for integer weights, so long paths
+ * cannot overflow, and double for floating point weights.
+ *
+ * @tparam W weight type, e.g. uint16_t, uint32_t, float or double
+ */
+template<class W>
+struct WeightTraits {
+    static_assert(std::is_arithmetic_v<W>, "edge weights must be arithmetic");
+
+    /**
+     * Type of a sum of weights.
+     */
+    using Distance = std::conditional_t<std::is_integral_v<W>,
+            std::conditional_t<std::is_signed_v<W>, int64_t, uint64_t>, double>;
+
+    /**
+     * True when distances are integers, which allows monotone integer queues (RadixHeap).
+     */
+    static constexpr bool INTEGRAL = std::is_integral_v<W>;
+
+    /**
+     * @return The distance of an unreachable vertex.
+     */
+    static constexpr Distance infinity() {
+        if constexpr (INTEGRAL) return std::numeric_limits<Distance>::max();
+        else return std::numeric_limits<Distance>::infinity();
+    }
+};
+
+#endif //GRAPHALGORITHM_WEIGHTTRAITS_HPP
@@ -6,8 +6,11 @@
 #define GRAPHALGORITHM_HEAP_HPP
 
 #include <iostream>
+#include <utility>
 #include <vector>
 
+#include "MemoryUsage.hpp"
+
 template <class T>
 class Heap {
 protected:
@@ -15,6 +18,11 @@ protected:
     size_t size;
     Heap() : size(0){}
 
+public:
+    virtual ~Heap() = default;
+
+protected:
+
     /**
      * @brief Swaps the current element with its child at the left or right, only if the child has higher priority.
      *
@@ -77,13 +85,13 @@ public:
     /**
      * @brief Retrieves and removes the element with the highest priority.
      *
-     * This method returns a reference to the element with the highest priority in the heap.
+     * This method returns the element with the highest priority in the heap.
      * The element is also removed from the heap.
      *
      * @note The time complexity of this operation is O(log n), where n is the number of elements in the heap.
-     * @return A read/write reference to the element with the highest priority.
+     * @return The element with the highest priority.
      */
-    T& pool();
+    T pool();
 
     /**
      * @brief Retrieves, without removing, the element with the highest priority.
@@ -102,6 +110,11 @@ public:
      */
     void clear();
 
+    /**
+     * @return The bytes of the heap array, at its allocated capacity.
+     */
+    MemoryUsage memoryUsage() const;
+
 
     friend std::ostream &operator<<(std::ostream &os, const Heap &heaps) {
         os << "{";
@@ -125,6 +138,11 @@ void Heap<T>::clear() {
     this->size = 0;
 }
 
+template<class T>
+MemoryUsage Heap<T>::memoryUsage() const {
+    return MemoryUsage::of(heap);
+}
+
 template<class T>
 const T& Heap<T>::peek() const {
     if (this->size == 0) throw std::exception();
@@ -133,20 +151,18 @@ const T& Heap<T>::peek() const {
 
 template<class T>
 void Heap<T>::exchange(int v1, int v2) {
-    T aux = heap[v1];
-    heap[v1] = heap[v2];
-    heap[v2] = aux;
+    std::swap(heap[v1], heap[v2]);
 }
 
 template<class T>
-T& Heap<T>::pool() {
+T Heap<T>::pool() {
     if (this->size <= 0) throw std::exception();
 
     this->exchange(0, size - 1);
 
-    T &result = *(this->heap.end() - 1);
+    T result = std::move(heap.back());
 
-    heap.erase((this->heap.end() - 1));
+    heap.pop_back();
     size--;
     if (this->size > 1) sink(0);
     return result;
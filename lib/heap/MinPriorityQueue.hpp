@@ -26,7 +26,7 @@ void MinPriorityQueue<T>::swim(int childIndex) {
     int PARENT_POS = childIndex / 2;
     PARENT_POS -= (childIndex % 2 == 0) ? 1 : 0;
 
-    while (this->heap[childIndex] < heap[PARENT_POS] && childIndex != 0){
+    while (childIndex != 0 && this->heap[childIndex] < heap[PARENT_POS]){
         this->exchange(childIndex, PARENT_POS);
         childIndex = PARENT_POS;
         PARENT_POS = childIndex / 2;
@@ -37,22 +37,20 @@ void MinPriorityQueue<T>::swim(int childIndex) {
 
 template<class T>
 void MinPriorityQueue<T>::sink(int parentIndex) {
-    int LEFT = std::min(parentIndex * 2 + 1, (int) this->size - 1);
-    int RIGHT = std::min(2 * (parentIndex + 1), (int) this->size - 1);
-
     std::vector<T> &heap = this->heap;
+    const int SIZE = (int) this->size;
 
-    while (heap[parentIndex] > heap[LEFT] || heap[parentIndex] > heap[RIGHT]) {
-        const int SMALLER_OF = (heap[LEFT] <= heap[RIGHT]) ? LEFT : RIGHT;
+    int LEFT = parentIndex * 2 + 1;
+    while (LEFT < SIZE) {
+        const int RIGHT = LEFT + 1;
+        const int SMALLER_OF = (RIGHT < SIZE && heap[RIGHT] < heap[LEFT]) ? RIGHT : LEFT;
+        if (!(heap[SMALLER_OF] < heap[parentIndex])) break;
 
         this->exchange(parentIndex, SMALLER_OF);
         parentIndex = SMALLER_OF;
-        LEFT = std::min(parentIndex * 2 + 1, (int) this->size - 1);
-        RIGHT = std::min(2 * (parentIndex + 1), (int) this->size - 1);
+        LEFT = parentIndex * 2 + 1;
     }
 
 }
 
-
-
 #endif //GRAPHALGORITHM_MINHEAP_HPP
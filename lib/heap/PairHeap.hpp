@@ -21,7 +21,7 @@ private:
     public:
         CMP comp;
         T data;
-        Pair(T data, CMP comp): data(data), comp(comp){}
+        Pair(T data, CMP comp): comp(comp), data(std::move(data)){}
         Pair() = default;
 
         /**
@@ -94,9 +94,9 @@ public:
     /**
      * @brief Retrieves and removes the element with the highest priority.
      *
-     * @return A read/write reference to the data element with the highest priority.
+     * @return The data element with the highest priority.
      */
-    T& pool();
+    T pool();
 
     /**
      * @brief Retrieves, without removing, the element with the highest priority.
@@ -127,8 +127,18 @@ public:
      * @return The weight (priority) of the element with the highest priority.
      */
     CMP peekWeight() const;
+
+    /**
+     * @return The bytes of the underlying heap array.
+     */
+    MemoryUsage memoryUsage() const;
 };
 
+template<class T, class CMP>
+MemoryUsage PairHeap<T, CMP>::memoryUsage() const {
+    return heap != nullptr ? heap->memoryUsage() : MemoryUsage();
+}
+
 template<class T, class CMP>
 CMP PairHeap<T, CMP>::peekWeight() const {
     return this->heap->peek().comp;
@@ -167,7 +177,7 @@ bool PairHeap<T, COMP_VALUE>::isEmpty() const{
 }
 
 template<class T, class COMP_VALUE>
-T& PairHeap<T, COMP_VALUE>::pool() {
+T PairHeap<T, COMP_VALUE>::pool() {
     return this->heap->pool().data;
 }
 
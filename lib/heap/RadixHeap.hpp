@@ -0,0 +1,150 @@
+#ifndef GRAPHALGORITHM_RADIXHEAP_HPP
+#define GRAPHALGORITHM_RADIXHEAP_HPP
+
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "MemoryUsage.hpp"
+
+/**
+ * A monotone min-priority queue for unsigned integer keys.
+ *
+ * Valid as long as no key smaller than the last removed one is added, which is always the case
+ * in Dijkstra with non-negative integer weights. Elements live in 65 buckets chosen by the
+ * highest bit in which their key differs from the last removed key, so add is O(1) and each
+ * element is moved between buckets at most 64 times, with no comparisons against other keys.
+ *
+ * Offers the same add/pool/peekWeight surface as PairHeap so algorithms can swap one for the other.
+ *
+ * @tparam T The data to be stored in the heap.
+ */
+template<class T>
+class RadixHeap {
+    std::vector<std::pair<uint64_t, T>> buckets[65];
+    uint64_t last = 0;
+    size_t count = 0;
+
+    static int bucketOf(uint64_t key, uint64_t last);
+
+    /**
+     * @brief Makes sure bucket 0 holds the elements with the minimum key.
+     */
+    void refill();
+
+public:
+    RadixHeap() = default;
+
+    /**
+     * @brief Adds a new element with a given key.
+     *
+     * @param data The data element to be added.
+     * @param key The priority, must not be smaller than the key of the last removed element.
+     */
+    void add(T data, uint64_t key);
+
+    /**
+     * @return The number of elements stored in the heap.
+     */
+    size_t size() const;
+
+    /**
+     * @return True if there is no element in the heap.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @return The bytes of the 65 buckets, at their allocated capacity.
+     */
+    MemoryUsage memoryUsage() const;
+
+    /**
+     * @brief Removes every element and resets the monotone lower bound to 0.
+     */
+    void clear();
+
+    /**
+     * @brief Retrieves and removes an element with the smallest key.
+     *
+     * @return The data element with the smallest key.
+     */
+    T pool();
+
+    /**
+     * @return The smallest key in the heap.
+     */
+    uint64_t peekWeight();
+};
+
+template<class T>
+int RadixHeap<T>::bucketOf(uint64_t key, uint64_t last) {
+    return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+}
+
+template<class T>
+void RadixHeap<T>::refill() {
+    if (!buckets[0].empty()) return;
+
+    int i = 1;
+    while (buckets[i].empty()) i++;
+
+    uint64_t smallest = buckets[i][0].first;
+    for (const auto &entry : buckets[i])
+        if (entry.first < smallest) smallest = entry.first;
+
+    last = smallest;
+    for (auto &entry : buckets[i])
+        buckets[bucketOf(entry.first, last)].push_back(std::move(entry));
+    buckets[i].clear();
+}
+
+template<class T>
+void RadixHeap<T>::add(T data, uint64_t key) {
+    buckets[bucketOf(key, last)].emplace_back(key, std::move(data));
+    count++;
+}
+
+template<class T>
+size_t RadixHeap<T>::size() const {
+    return count;
+}
+
+template<class T>
+MemoryUsage RadixHeap<T>::memoryUsage() const {
+    MemoryUsage usage;
+    for (const auto &bucket : buckets) usage += MemoryUsage::of(bucket);
+    return usage;
+}
+
+template<class T>
+bool RadixHeap<T>::isEmpty() const {
+    return count == 0;
+}
+
+template<class T>
+void RadixHeap<T>::clear() {
+    for (auto &bucket : buckets) bucket.clear();
+    last = 0;
+    count = 0;
+}
+
+template<class T>
+T RadixHeap<T>::pool() {
+    if (count == 0) throw std::exception();
+    refill();
+
+    T result = std::move(buckets[0].back().second);
+    buckets[0].pop_back();
+    count--;
+    return result;
+}
+
+template<class T>
+uint64_t RadixHeap<T>::peekWeight() {
+    if (count == 0) throw std::exception();
+    refill();
+    return last;
+}
+
+#endif //GRAPHALGORITHM_RADIXHEAP_HPP
@@ -0,0 +1,431 @@
+#ifndef GRAPHALGORITHM_GRAPHLOADER_HPP
+#define GRAPHALGORITHM_GRAPHLOADER_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "CsrGraph.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Options shared by every GraphLoader entry point.
+ */
+struct GraphLoadOptions {
+    /**
+     * Number of parser threads, 0 means std::thread::hardware_concurrency(). Chunks are parsed
+     * on ThreadPool::global(), so at most its thread count run at once.
+     */
+    unsigned threads = 0;
+
+    /**
+     * Whether an edge list describes arcs (true) or undirected edges (false).
+     * DIMACS files are always directed and Matrix Market files follow their header.
+     */
+    bool directed = true;
+};
+
+/**
+ * Reads graph files straight into a CsrGraph.
+ *
+ * The file is mmap'ed and split into newline-aligned chunks that are parsed concurrently
+ * with a hand-written number parser (no iostreams, no locale, no per-token allocation).
+ * Supported formats:
+ *  - whitespace edge lists: "from to [weight]" per line, 0-based ids, '#' or '%' comments;
+ *  - DIMACS shortest path (.gr): "p sp n m" header and "a from to weight" arcs, 1-based ids;
+ *  - Matrix Market (.mtx): coordinate real/integer/pattern matrices, general or symmetric.
+ *
+ * A line is malformed if a number overflows, anything but blanks or a comment follows the optional
+ * weight, or the weight is not exactly representable in W (fractional, negative or out of range for
+ * an integral W; out of range for float).
+ */
+class GraphLoader {
+public:
+    /**
+     * @brief Loads a graph, picking the format from the file extension (.gr, .mtx, anything else is an edge list).
+     *
+     * @tparam W weight type of the returned graph
+     * @param path The file to be read.
+     * @param options Parser options.
+     * @return The graph in CSR layout.
+     * @throw std::runtime_error If the file cannot be read or is malformed.
+     */
+    template<class W = double>
+    static CsrGraph<W> load(const std::string &path, const GraphLoadOptions &options = GraphLoadOptions());
+
+    /**
+     * @brief Loads a whitespace separated edge list. Lines without a weight get weight 1.
+     *
+     * The vertex count is the greatest id found plus one.
+     */
+    template<class W = double>
+    static CsrGraph<W> loadEdgeList(const std::string &path, const GraphLoadOptions &options = GraphLoadOptions());
+
+    /**
+     * @brief Loads a DIMACS shortest path (.gr) file as a directed graph.
+     */
+    template<class W = double>
+    static CsrGraph<W> loadDimacs(const std::string &path, const GraphLoadOptions &options = GraphLoadOptions());
+
+    /**
+     * @brief Loads a Matrix Market coordinate file. Entry (i, j) becomes the arc i -> j;
+     * symmetric matrices produce an undirected graph and pattern matrices get weight 1.
+     */
+    template<class W = double>
+    static CsrGraph<W> loadMatrixMarket(const std::string &path, const GraphLoadOptions &options = GraphLoadOptions());
+
+private:
+    enum class Format { EDGE_LIST, DIMACS, MATRIX_MARKET };
+
+    /**
+     * What a single parser thread produced for its chunk.
+     */
+    template<class W>
+    struct ChunkResult {
+        std::vector<typename CsrGraph<W>::Arc> arcs;
+        uint64_t maxId = 0;
+        const char *error = nullptr;
+    };
+
+    static constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
+
+    static bool isBlank(char c);
+    static const char *skipBlanks(const char *p, const char *end);
+    static const char *nextLine(const char *p, const char *end);
+    static bool atLineEnd(const char *p, const char *end, Format format);
+    static bool parseUnsigned(const char *&p, const char *end, uint64_t &out);
+    static bool parseReal(const char *&p, const char *end, double &out);
+    static size_t lineNumber(const char *begin, const char *at);
+    static unsigned resolveThreads(const GraphLoadOptions &options, size_t bytes);
+
+    template<class W>
+    static bool fitsWeight(double weight);
+
+    template<class W>
+    static void parseChunk(const char *p, const char *end, Format format, uint64_t idBase, ChunkResult<W> &result);
+
+    template<class W>
+    static CsrGraph<W> parseBody(const std::string &source, const char *begin, const char *body, const char *end,
+                                 Format format, size_t declaredVertices, bool directed, unsigned threads);
+};
+
+inline bool GraphLoader::isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char *GraphLoader::skipBlanks(const char *p, const char *end) {
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+inline const char *GraphLoader::nextLine(const char *p, const char *end) {
+    const void *newline = std::memchr(p, '\n', end - p);
+    return newline == nullptr ? end : static_cast<const char *>(newline) + 1;
+}
+
+/**
+ * @return True if p is at the end of the line or at the start of a trailing comment.
+ */
+inline bool GraphLoader::atLineEnd(const char *p, const char *end, Format format) {
+    if (p == end || *p == '\n') return true;
+    switch (format) {
+        case Format::EDGE_LIST: return *p == '#' || *p == '%';
+        case Format::MATRIX_MARKET: return *p == '%';
+        default: return false;
+    }
+}
+
+/**
+ * @return False if there is no digit at p or the number does not fit in 64 bits.
+ */
+inline bool GraphLoader::parseUnsigned(const char *&p, const char *end, uint64_t &out) {
+    const char *start = p;
+    uint64_t value = 0;
+    while (p < end && static_cast<unsigned>(*p - '0') < 10) {
+        const unsigned digit = *p - '0';
+        if (value > (UINT64_MAX - digit) / 10) return false;
+        value = value * 10 + digit;
+        ++p;
+    }
+    out = value;
+    return p != start;
+}
+
+inline bool GraphLoader::parseReal(const char *&p, const char *end, double &out) {
+    static const double EXACT_POWERS[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                          1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+
+    for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p, any = true) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) digits++;
+        } else {
+            exponent++;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        for (++p; p < end && static_cast<unsigned>(*p - '0') < 10; ++p, any = true) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            }
+        }
+    }
+
+    if (!any) return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) negativeExponent = *p++ == '-';
+        uint64_t value;
+        if (!parseUnsigned(p, end, value)) return false;
+        int scaled = static_cast<int>(std::min<uint64_t>(value, 9999));
+        exponent += negativeExponent ? -scaled : scaled;
+    }
+
+    double result = static_cast<double>(mantissa);
+    // both operands exact -> a single correctly rounded operation
+    if (mantissa < (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+        result = exponent >= 0 ? result * EXACT_POWERS[exponent] : result / EXACT_POWERS[-exponent];
+    else if (mantissa != 0)
+        result *= std::pow(10.0, exponent);
+
+    out = negative ? -result : result;
+    return true;
+}
+
+inline size_t GraphLoader::lineNumber(const char *begin, const char *at) {
+    return std::count(begin, at, '\n') + 1;
+}
+
+inline unsigned GraphLoader::resolveThreads(const GraphLoadOptions &options, size_t bytes) {
+    unsigned threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+    size_t useful = bytes / MIN_CHUNK_BYTES + 1;
+    return static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, useful)));
+}
+
+/**
+ * @return True if the parsed weight converts to W without overflow or, for integral W, rounding.
+ */
+template<class W>
+bool GraphLoader::fitsWeight(double weight) {
+    if (!std::isfinite(weight)) return false;
+    if constexpr (std::is_integral_v<W>) {
+        // 2^digits is exact in a double, unlike numeric_limits<W>::max() for 64-bit W
+        const double limit = std::ldexp(1.0, std::numeric_limits<W>::digits);
+        return weight == std::trunc(weight) && weight < limit && weight >= (std::is_signed_v<W> ? -limit : 0.0);
+    } else {
+        return std::fabs(weight) <= static_cast<double>(std::numeric_limits<W>::max());
+    }
+}
+
+template<class W>
+void GraphLoader::parseChunk(const char *p, const char *end, Format format, uint64_t idBase, ChunkResult<W> &result) {
+    const uint64_t MAX_ID = std::numeric_limits<typename CsrGraph<W>::VertexId>::max() - 1;
+
+    for (const char *line = p; line < end; line = nextLine(line, end)) {
+        const char *cursor = skipBlanks(line, end);
+        if (cursor == end || *cursor == '\n') continue;
+
+        switch (format) {
+            case Format::EDGE_LIST:
+                if (*cursor == '#' || *cursor == '%') continue;
+                break;
+            case Format::DIMACS:
+                if (*cursor == 'c' || *cursor == 'p') continue;
+                if (*cursor != 'a') {
+                    result.error = line;
+                    return;
+                }
+                cursor = skipBlanks(cursor + 1, end);
+                break;
+            case Format::MATRIX_MARKET:
+                if (*cursor == '%') continue;
+                break;
+        }
+
+        uint64_t from, to;
+        if (!parseUnsigned(cursor, end, from) || cursor == end || !isBlank(*cursor)) {
+            result.error = line;
+            return;
+        }
+        cursor = skipBlanks(cursor, end);
+        if (!parseUnsigned(cursor, end, to) || !(atLineEnd(cursor, end, format) || isBlank(*cursor))
+            || from < idBase || to < idBase || from - idBase > MAX_ID || to - idBase > MAX_ID) {
+            result.error = line;
+            return;
+        }
+        from -= idBase;
+        to -= idBase;
+
+        // an optional weight, then nothing but blanks or a comment
+        double weight = 1;
+        cursor = skipBlanks(cursor, end);
+        if ((!atLineEnd(cursor, end, format)
+             && (!parseReal(cursor, end, weight) || !atLineEnd(skipBlanks(cursor, end), end, format)))
+            || !fitsWeight<W>(weight)) {
+            result.error = line;
+            return;
+        }
+
+        result.maxId = std::max(result.maxId, std::max(from, to));
+        result.arcs.push_back({static_cast<typename CsrGraph<W>::VertexId>(from),
+                               static_cast<typename CsrGraph<W>::VertexId>(to),
+                               static_cast<W>(weight)});
+    }
+}
+
+template<class W>
+CsrGraph<W> GraphLoader::parseBody(const std::string &source, const char *begin, const char *body, const char *end,
+                                   Format format, size_t declaredVertices, bool directed, unsigned threads) {
+    const uint64_t idBase = format == Format::EDGE_LIST ? 0 : 1;
+    if (declaredVertices > std::numeric_limits<typename CsrGraph<W>::VertexId>::max())
+        throw std::runtime_error(source + ": declared size " + std::to_string(declaredVertices) + " is too large");
+
+    // chunk i holds every line whose first byte lies in [bounds[i], bounds[i + 1])
+    std::vector<const char *> bounds(threads + 1, end);
+    bounds[0] = body;
+    for (unsigned i = 1; i < threads; i++) {
+        const char *raw = body + (end - body) * i / threads;
+        bounds[i] = std::max(bounds[i - 1], raw == body ? body : nextLine(raw - 1, end));
+    }
+
+    std::vector<ChunkResult<W>> results(threads);
+    ParallelOptions parallel;
+    parallel.threads = threads;
+    parallel.grain = 1;
+    ThreadPool::global().parallelFor(0, threads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) parseChunk(bounds[i], bounds[i + 1], format, idBase, results[i]);
+    }, parallel);
+
+    uint64_t maxId = 0;
+    bool anyArc = false;
+    for (const auto &result : results) {
+        if (result.error != nullptr)
+            throw std::runtime_error(source + ":" + std::to_string(lineNumber(begin, result.error)) + ": malformed line");
+        if (!result.arcs.empty()) {
+            maxId = std::max(maxId, result.maxId);
+            anyArc = true;
+        }
+    }
+
+    size_t vertexCount = declaredVertices;
+    if (format == Format::EDGE_LIST) {
+        vertexCount = anyArc ? maxId + 1 : 0;
+    } else if (anyArc && maxId >= declaredVertices) {
+        throw std::runtime_error(source + ": vertex id " + std::to_string(maxId + 1) + " exceeds the declared size");
+    }
+
+    std::vector<std::vector<typename CsrGraph<W>::Arc>> chunks(threads);
+    for (unsigned i = 0; i < threads; i++) chunks[i] = std::move(results[i].arcs);
+    return CsrGraph<W>::fromArcs(vertexCount, chunks, directed);
+}
+
+template<class W>
+CsrGraph<W> GraphLoader::load(const std::string &path, const GraphLoadOptions &options) {
+    auto endsWith = [&path](const std::string &suffix) {
+        return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    if (endsWith(".gr")) return loadDimacs<W>(path, options);
+    if (endsWith(".mtx")) return loadMatrixMarket<W>(path, options);
+    return loadEdgeList<W>(path, options);
+}
+
+template<class W>
+CsrGraph<W> GraphLoader::loadEdgeList(const std::string &path, const GraphLoadOptions &options) {
+    MappedFile file(path);
+    const char *begin = file.data();
+    const char *end = begin + file.size();
+    return parseBody<W>(path, begin, begin, end, Format::EDGE_LIST, 0, options.directed,
+                        resolveThreads(options, file.size()));
+}
+
+template<class W>
+CsrGraph<W> GraphLoader::loadDimacs(const std::string &path, const GraphLoadOptions &options) {
+    MappedFile file(path);
+    const char *begin = file.data();
+    const char *end = begin + file.size();
+
+    // the problem line must precede the first arc, everything before it is comments
+    for (const char *line = begin; line < end; line = nextLine(line, end)) {
+        const char *cursor = skipBlanks(line, end);
+        if (cursor == end || *cursor == '\n' || *cursor == 'c') continue;
+        if (*cursor != 'p') break;
+
+        cursor = skipBlanks(cursor + 1, end);
+        while (cursor < end && !isBlank(*cursor) && *cursor != '\n') ++cursor;
+        cursor = skipBlanks(cursor, end);
+
+        uint64_t vertices;
+        if (!parseUnsigned(cursor, end, vertices))
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber(begin, line)) + ": malformed problem line");
+
+        const char *body = nextLine(line, end);
+        return parseBody<W>(path, begin, body, end, Format::DIMACS, vertices, true,
+                            resolveThreads(options, end - body));
+    }
+
+    throw std::runtime_error(path + ": missing DIMACS problem line");
+}
+
+template<class W>
+CsrGraph<W> GraphLoader::loadMatrixMarket(const std::string &path, const GraphLoadOptions &options) {
+    MappedFile file(path);
+    const char *begin = file.data();
+    const char *end = begin + file.size();
+    if (begin == end) throw std::runtime_error(path + ": not a Matrix Market coordinate file");
+
+    const char *bannerEnd = nextLine(begin, end);
+    std::string banner(begin, bannerEnd);
+    std::transform(banner.begin(), banner.end(), banner.begin(), [](char c) { return (char) std::tolower(c); });
+
+    if (banner.rfind("%%matrixmarket", 0) != 0 || banner.find("coordinate") == std::string::npos)
+        throw std::runtime_error(path + ": not a Matrix Market coordinate file");
+    if (banner.find("complex") != std::string::npos || banner.find("skew") != std::string::npos
+        || banner.find("hermitian") != std::string::npos)
+        throw std::runtime_error(path + ": unsupported Matrix Market field or symmetry");
+    bool symmetric = banner.find("symmetric") != std::string::npos;
+
+    for (const char *line = bannerEnd; line < end; line = nextLine(line, end)) {
+        const char *cursor = skipBlanks(line, end);
+        if (cursor == end || *cursor == '\n' || *cursor == '%') continue;
+
+        uint64_t sizes[3];
+        bool valid = true;
+        for (auto &size : sizes) {
+            valid = valid && parseUnsigned(cursor, end, size);
+            cursor = skipBlanks(cursor, end);
+        }
+        if (!valid)
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber(begin, line)) + ": malformed size line");
+
+        const char *body = nextLine(line, end);
+        return parseBody<W>(path, begin, body, end, Format::MATRIX_MARKET, std::max(sizes[0], sizes[1]), !symmetric,
+                            resolveThreads(options, end - body));
+    }
+
+    throw std::runtime_error(path + ": missing Matrix Market size line");
+}
+
+#endif //GRAPHALGORITHM_GRAPHLOADER_HPP
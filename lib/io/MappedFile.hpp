@@ -0,0 +1,80 @@
+#ifndef GRAPHALGORITHM_MAPPEDFILE_HPP
+#define GRAPHALGORITHM_MAPPEDFILE_HPP
+
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * A read-only memory mapping of a whole file, unmapped on destruction.
+ */
+class MappedFile {
+    const char *bytes = nullptr;
+    size_t length = 0;
+
+public:
+    /**
+     * @brief Maps the file read-only and hints the kernel that it will be read sequentially.
+     *
+     * @param path The file to be mapped.
+     * @throw std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @return The first byte of the file, or nullptr for an empty file.
+     */
+    const char *data() const;
+
+    /**
+     * @return The size of the file in bytes.
+     */
+    size_t size() const;
+};
+
+inline MappedFile::MappedFile(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot mmap " + path);
+        }
+        ::madvise(mapping, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const char *>(mapping);
+    }
+
+    ::close(fd);
+}
+
+inline MappedFile::~MappedFile() {
+    if (bytes != nullptr)
+        ::munmap(const_cast<char *>(bytes), length);
+}
+
+inline const char *MappedFile::data() const {
+    return bytes;
+}
+
+inline size_t MappedFile::size() const {
+    return length;
+}
+
+#endif //GRAPHALGORITHM_MAPPEDFILE_HPP
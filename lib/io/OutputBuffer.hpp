@@ -0,0 +1,121 @@
+#ifndef GRAPHALGORITHM_OUTPUTBUFFER_HPP
+#define GRAPHALGORITHM_OUTPUTBUFFER_HPP
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * An append-only byte buffer in front of a std::ostream or a FILE*.
+ *
+ * Text is copied into a large private buffer and handed to the sink in big blocks, so
+ * writers that emit millions of short tokens pay neither a virtual call nor a flush per token.
+ * The remaining bytes are flushed on destruction.
+ */
+class OutputBuffer {
+    std::ostream *stream = nullptr;
+    FILE *file = nullptr;
+    std::vector<char> buffer;
+    size_t used = 0;
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit OutputBuffer(std::ostream &os, size_t capacity = DEFAULT_CAPACITY);
+    explicit OutputBuffer(FILE *out, size_t capacity = DEFAULT_CAPACITY);
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    /**
+     * @brief Appends a single character.
+     */
+    void put(char c);
+
+    /**
+     * @brief Appends length bytes starting at text.
+     */
+    void write(const char *text, size_t length);
+
+    /**
+     * @brief Appends a null terminated string.
+     */
+    void write(const char *text);
+
+    /**
+     * @brief Appends the content of a string.
+     */
+    void write(const std::string &text);
+
+    /**
+     * @brief Appends the decimal representation of a number. Floating point values use the
+     * same shortest "%g" form as the default std::ostream formatting.
+     */
+    template<class N>
+    void writeNumber(N value);
+
+    /**
+     * @brief Hands everything buffered so far to the underlying sink.
+     */
+    void flush();
+};
+
+inline OutputBuffer::OutputBuffer(std::ostream &os, size_t capacity) : stream(&os), buffer(capacity) {}
+
+inline OutputBuffer::OutputBuffer(FILE *out, size_t capacity) : file(out), buffer(capacity) {}
+
+inline OutputBuffer::~OutputBuffer() {
+    flush();
+}
+
+inline void OutputBuffer::put(char c) {
+    if (used == buffer.size()) flush();
+    buffer[used++] = c;
+}
+
+inline void OutputBuffer::write(const char *text, size_t length) {
+    if (used + length > buffer.size()) {
+        flush();
+        if (length > buffer.size()) {
+            if (stream != nullptr) stream->write(text, (std::streamsize) length);
+            else fwrite(text, 1, length, file);
+            return;
+        }
+    }
+    std::memcpy(buffer.data() + used, text, length);
+    used += length;
+}
+
+inline void OutputBuffer::write(const char *text) {
+    write(text, std::strlen(text));
+}
+
+inline void OutputBuffer::write(const std::string &text) {
+    write(text.data(), text.size());
+}
+
+template<class N>
+void OutputBuffer::writeNumber(N value) {
+    char digits[32];
+    if constexpr (std::is_integral_v<N>) {
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        write(digits, result.ptr - digits);
+    } else {
+        int length = std::snprintf(digits, sizeof(digits), "%g", (double) value);
+        write(digits, (size_t) length);
+    }
+}
+
+inline void OutputBuffer::flush() {
+    if (used == 0) return;
+    if (stream != nullptr) stream->write(buffer.data(), (std::streamsize) used);
+    else fwrite(buffer.data(), 1, used, file);
+    used = 0;
+}
+
+#endif //GRAPHALGORITHM_OUTPUTBUFFER_HPP
@@ -0,0 +1,166 @@
+#ifndef GRAPHALGORITHM_ARENARESOURCE_HPP
+#define GRAPHALGORITHM_ARENARESOURCE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "MemoryUsage.hpp"
+
+/**
+ * A monotonic std::pmr::memory_resource that can be rewound and reused.
+ *
+ * Allocation bumps a pointer through a list of blocks obtained from an upstream resource, each
+ * twice as big as the previous one; deallocation does nothing. reset() rewinds to the first
+ * block in O(1) and keeps every block, so once the arena has grown to the size of a workload,
+ * repeating that workload allocates nothing upstream. This is what the scratch state of a
+ * search wants: many small nodes, all dropped together before the next search.
+ *
+ * Unlike std::pmr::monotonic_buffer_resource, whose release() hands the blocks back upstream,
+ * reset() keeps them.
+ *
+ * @note Not synchronized, like std::pmr::monotonic_buffer_resource.
+ */
+class ArenaResource : public std::pmr::memory_resource {
+    struct Block {
+        std::byte *memory;
+        size_t size;
+    };
+
+    std::pmr::memory_resource *upstream;
+    std::vector<Block> blocks;
+    size_t current = 0;
+    std::byte *cursor = nullptr;
+    std::byte *limit = nullptr;
+    size_t nextSize;
+    size_t used = 0;
+
+    static constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+    /**
+     * @brief Moves to the next kept block large enough for the request, or adds a new one.
+     */
+    void grow(size_t bytes, size_t alignment);
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+public:
+    /**
+     * @param initialSize Size of the first block, in bytes.
+     * @param upstream Where the blocks come from.
+     */
+    explicit ArenaResource(size_t initialSize = 64 * 1024,
+                           std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+    ~ArenaResource() override;
+
+    ArenaResource(const ArenaResource &) = delete;
+    ArenaResource &operator=(const ArenaResource &) = delete;
+
+    /**
+     * @brief Makes every block available again, in O(1). Everything allocated so far is forgotten:
+     * the objects living in the arena must be gone or never be touched again.
+     */
+    void reset();
+
+    /**
+     * @brief Returns every block to the upstream resource.
+     */
+    void release();
+
+    /**
+     * @return The bytes handed out since the last reset.
+     */
+    size_t getUsed() const;
+
+    /**
+     * @return The bytes of all the blocks kept by the arena.
+     */
+    size_t getCapacity() const;
+
+    /**
+     * @return The blocks of the arena, as element storage.
+     */
+    MemoryUsage memoryUsage() const;
+};
+
+inline ArenaResource::ArenaResource(size_t initialSize, std::pmr::memory_resource *upstream)
+    : upstream(upstream), nextSize(std::max<size_t>(initialSize, 256)) {}
+
+inline ArenaResource::~ArenaResource() {
+    release();
+}
+
+inline void ArenaResource::grow(size_t bytes, size_t alignment) {
+    const size_t needed = bytes + alignment;
+    while (current + 1 < blocks.size()) {
+        current++;
+        if (blocks[current].size >= needed) {
+            cursor = blocks[current].memory;
+            limit = cursor + blocks[current].size;
+            return;
+        }
+    }
+
+    const size_t size = std::max(nextSize, needed);
+    blocks.push_back({static_cast<std::byte *>(upstream->allocate(size, BLOCK_ALIGNMENT)), size});
+    nextSize = size * 2;
+    current = blocks.size() - 1;
+    cursor = blocks[current].memory;
+    limit = cursor + size;
+}
+
+inline void *ArenaResource::do_allocate(size_t bytes, size_t alignment) {
+    auto aligned = [&]() {
+        const auto address = reinterpret_cast<uintptr_t>(cursor);
+        return cursor + ((alignment - address % alignment) % alignment);
+    };
+
+    std::byte *start = cursor != nullptr ? aligned() : nullptr;
+    if (start == nullptr || start + bytes > limit) {
+        grow(bytes, alignment);
+        start = aligned();
+    }
+
+    cursor = start + bytes;
+    used += bytes;
+    return start;
+}
+
+inline void ArenaResource::reset() {
+    used = 0;
+    current = 0;
+    if (blocks.empty()) return;
+    cursor = blocks[0].memory;
+    limit = cursor + blocks[0].size;
+}
+
+inline void ArenaResource::release() {
+    for (const Block &block : blocks) upstream->deallocate(block.memory, block.size, BLOCK_ALIGNMENT);
+    blocks.clear();
+    current = 0;
+    cursor = limit = nullptr;
+    used = 0;
+}
+
+inline size_t ArenaResource::getUsed() const {
+    return used;
+}
+
+inline size_t ArenaResource::getCapacity() const {
+    size_t capacity = 0;
+    for (const Block &block : blocks) capacity += block.size;
+    return capacity;
+}
+
+inline MemoryUsage ArenaResource::memoryUsage() const {
+    MemoryUsage usage;
+    usage.elements = getCapacity();
+    return usage;
+}
+
+#endif //GRAPHALGORITHM_ARENARESOURCE_HPP
@@ -0,0 +1,182 @@
+#ifndef GRAPHALGORITHM_MEMORYUSAGE_HPP
+#define GRAPHALGORITHM_MEMORYUSAGE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Running totals of the bytes requested through a CountingAllocator.
+ *
+ * @note Not synchronized: share a counter only between containers used by one thread at a time.
+ */
+struct MemoryCounter {
+    size_t bytes = 0;
+    size_t peakBytes = 0;
+    size_t allocations = 0;
+
+    void allocated(size_t n) {
+        bytes += n;
+        allocations++;
+        if (bytes > peakBytes) peakBytes = bytes;
+    }
+
+    void deallocated(size_t n) {
+        bytes -= n;
+    }
+};
+
+/**
+ * A std::allocator that reports every allocation and deallocation to a MemoryCounter.
+ *
+ * Plug it into a standard container to budget it exactly, e.g.
+ * std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, CountingAllocator<std::pair<const K, V>>>.
+ * Rebound copies (node and bucket allocators) keep reporting to the same counter.
+ *
+ * @tparam T The allocated type.
+ */
+template<class T>
+class CountingAllocator {
+    template<class U> friend class CountingAllocator;
+
+    MemoryCounter *counter;
+
+public:
+    using value_type = T;
+
+    explicit CountingAllocator(MemoryCounter *counter) : counter(counter) {}
+
+    template<class U>
+    CountingAllocator(const CountingAllocator<U> &other) : counter(other.counter) {}
+
+    T *allocate(size_t n) {
+        T *memory = std::allocator<T>().allocate(n);
+        counter->allocated(n * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T *memory, size_t n) {
+        counter->deallocated(n * sizeof(T));
+        std::allocator<T>().deallocate(memory, n);
+    }
+
+    MemoryCounter *getCounter() const { return counter; }
+
+    template<class U>
+    bool operator==(const CountingAllocator<U> &other) const { return counter == other.counter; }
+
+    template<class U>
+    bool operator!=(const CountingAllocator<U> &other) const { return counter != other.counter; }
+};
+
+/**
+ * Bytes held by a data structure, split by what they are used for.
+ *
+ * Sizes are the bytes requested from the allocator; malloc headers and rounding are not counted.
+ */
+struct MemoryUsage {
+    /**
+     * Bucket arrays of node-based hash containers.
+     */
+    size_t buckets = 0;
+
+    /**
+     * One allocation per element of node-based containers (the vertex entries of a Graph, the
+     * scratch maps of a GraphAlgorithm).
+     */
+    size_t nodes = 0;
+
+    /**
+     * Contiguous element storage: flat edge tables, heap arrays, CSR arrays.
+     */
+    size_t elements = 0;
+
+    size_t total() const { return buckets + nodes + elements; }
+
+    MemoryUsage &operator+=(const MemoryUsage &other) {
+        buckets += other.buckets;
+        nodes += other.nodes;
+        elements += other.elements;
+        return *this;
+    }
+
+    /**
+     * @return The bytes of the allocated capacity of a vector.
+     */
+    template<class V, class A>
+    static MemoryUsage of(const std::vector<V, A> &vector) {
+        MemoryUsage usage;
+        usage.elements = vector.capacity() * sizeof(V);
+        return usage;
+    }
+
+    /**
+     * @return The bytes of a vector<bool>, which packs its elements in bits.
+     */
+    template<class A>
+    static MemoryUsage of(const std::vector<bool, A> &vector) {
+        MemoryUsage usage;
+        usage.elements = (vector.capacity() + 7) / 8;
+        return usage;
+    }
+
+    /**
+     * @return The bucket array and nodes of a hash map, not counting what the mapped values own.
+     */
+    template<class K, class V, class H, class E, class A>
+    static MemoryUsage of(const std::unordered_map<K, V, H, E, A> &map) {
+        using Measured = std::unordered_map<K, V, H, E, CountingAllocator<std::pair<const K, V>>>;
+        return ofHashed<Measured, std::pair<K, V>>(map.size(), map.bucket_count());
+    }
+
+    /**
+     * @return The bucket array and nodes of a hash set.
+     */
+    template<class K, class H, class E, class A>
+    static MemoryUsage of(const std::unordered_set<K, H, E, A> &set) {
+        using Measured = std::unordered_set<K, H, E, CountingAllocator<K>>;
+        return ofHashed<Measured, K>(set.size(), set.bucket_count());
+    }
+
+private:
+    /**
+     * @brief Sizes a node and a bucket of a standard hash container once, by filling a counted
+     * copy of its type, then scales them to the given geometry.
+     */
+    template<class Measured, class Value>
+    static MemoryUsage ofHashed(size_t size, size_t bucketCount) {
+        struct Layout {
+            size_t node;
+            size_t bucket;
+        };
+
+        static const Layout layout = []() {
+            Layout measured{0, sizeof(void *)};
+            if constexpr (std::is_default_constructible_v<Value>) {
+                MemoryCounter counter;
+                Measured probe(0, typename Measured::hasher(), typename Measured::key_equal(),
+                               typename Measured::allocator_type(&counter));
+                probe.rehash(64);
+                const size_t bucketBytes = counter.bytes;
+                measured.bucket = bucketBytes / probe.bucket_count();
+                probe.insert(Value());
+                measured.node = counter.bytes - bucketBytes;
+            } else {
+                measured.node = sizeof(typename Measured::value_type) + 2 * sizeof(void *);
+            }
+            return measured;
+        }();
+
+        MemoryUsage usage;
+        // libstdc++ keeps a single bucket inline until the first rehash
+        usage.buckets = bucketCount > 1 ? bucketCount * layout.bucket : 0;
+        usage.nodes = size * layout.node;
+        return usage;
+    }
+};
+
+#endif //GRAPHALGORITHM_MEMORYUSAGE_HPP
@@ -0,0 +1,339 @@
+#ifndef GRAPHALGORITHM_THREADPOOL_HPP
+#define GRAPHALGORITHM_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Per-call settings of ThreadPool::parallelFor and ThreadPool::parallelReduce.
+ */
+struct ParallelOptions {
+    /**
+     * Number of threads working on the call, the calling thread included. 0 means the whole pool.
+     */
+    unsigned threads = 0;
+
+    /**
+     * Size of the smallest range handed to the body. 0 picks it from the range size and the
+     * thread count (about 16 leaves per thread).
+     */
+    size_t grain = 0;
+};
+
+/**
+ * A work-stealing thread pool for the parallel parts of the library.
+ *
+ * Every worker owns a deque of tasks. A task is a slice [first, last) of a parallelFor range:
+ * the thread running it splits it in halves down to the grain size, pushes the right halves on
+ * its own deque and processes the left half. Owners pop from the back (the most recent, cache
+ * warm slices) and idle threads steal from the front of other deques (the biggest slices), so
+ * load balances itself without a central queue. Threads calling from outside the pool push to
+ * a shared injection deque and then work on their own call until it completes, which also
+ * makes nested calls from inside a body safe.
+ *
+ * @note No dependency beyond the standard library.
+ */
+class ThreadPool {
+    struct Job {
+        void (*run)(void *body, size_t first, size_t last);
+        void *body;
+        size_t grain;
+        unsigned limit;
+        int owner;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed{false};
+        std::mutex errorLock;
+        std::exception_ptr error;
+
+        bool admits(int worker) const { return worker == owner || worker + 1 < (int) limit; }
+    };
+
+    struct Task {
+        Job *job;
+        size_t first;
+        size_t last;
+    };
+
+    // one cache line per deque so that pushes by one worker do not slow down the others
+    struct alignas(64) WorkDeque {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    struct Identity {
+        const ThreadPool *pool = nullptr;
+        int index = -1;
+    };
+
+    // set before any worker starts, workers.size() is still growing while the first ones run
+    unsigned workerCount;
+    std::vector<std::thread> workers;
+    std::unique_ptr<WorkDeque[]> deques;
+    WorkDeque injection;
+
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<uint64_t> pushes{0};
+    std::atomic<int> sleeping{0};
+    bool stopping = false;
+
+    static Identity &identity();
+    int self() const;
+
+    void push(const Task &task, int worker);
+    bool take(WorkDeque &deque, int worker, bool back, Task &task);
+    bool find(int worker, Task &task);
+    void execute(const Task &task, int worker);
+    void workerLoop(int worker);
+    void runJob(Job &job, size_t begin, size_t end);
+
+public:
+    /**
+     * @param threads Total number of threads, the calling thread included: threads - 1 workers
+     *                are started. 0 means std::thread::hardware_concurrency().
+     */
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @return The pool shared by the library, sized to the hardware.
+     */
+    static ThreadPool &global();
+
+    /**
+     * @return The number of threads that can work on a call, the caller included.
+     */
+    unsigned getThreadCount() const;
+
+    /**
+     * @brief Calls body(first, last) on disjoint slices covering [begin, end), in parallel.
+     *
+     * Returns once every slice is processed. If a body throws, the remaining slices are skipped
+     * and the first exception is rethrown here.
+     *
+     * @param body Callable taking (size_t first, size_t last); it may itself call parallelFor.
+     * @param options Thread count and grain of this call.
+     */
+    template<class Body>
+    void parallelFor(size_t begin, size_t end, Body body, const ParallelOptions &options = ParallelOptions());
+
+    /**
+     * @brief Splits [begin, end) in slices of options.grain elements, maps each slice to a value
+     * and folds the values from left to right.
+     *
+     * The slicing only depends on the grain, so with an explicit grain the result is the same
+     * for every thread count, even for a combine that is not associative (floating point sums).
+     *
+     * @param identity The value of an empty range, also the start of the fold.
+     * @param map Callable taking (size_t first, size_t last) and returning a V.
+     * @param combine Callable taking (V, V) and returning a V.
+     * @return The folded value.
+     */
+    template<class V, class Map, class Combine>
+    V parallelReduce(size_t begin, size_t end, V identity, Map map, Combine combine,
+                     const ParallelOptions &options = ParallelOptions());
+};
+
+inline ThreadPool::Identity &ThreadPool::identity() {
+    static thread_local Identity current;
+    return current;
+}
+
+inline int ThreadPool::self() const {
+    const Identity &current = identity();
+    return current.pool == this ? current.index : -1;
+}
+
+inline ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    workerCount = threads - 1;
+    deques = std::make_unique<WorkDeque[]>(workerCount);
+    workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; i++)
+        workers.emplace_back([this, i]() { workerLoop((int) i); });
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers) worker.join();
+}
+
+inline ThreadPool &ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+inline unsigned ThreadPool::getThreadCount() const {
+    return workerCount + 1;
+}
+
+inline void ThreadPool::push(const Task &task, int worker) {
+    WorkDeque &deque = worker >= 0 ? deques[worker] : injection;
+    {
+        std::lock_guard<std::mutex> guard(deque.lock);
+        deque.tasks.push_back(task);
+    }
+
+    // a sleeper registers before checking pushes, so one of the two sides sees the other
+    pushes.fetch_add(1);
+    if (sleeping.load() > 0) {
+        { std::lock_guard<std::mutex> guard(sleepLock); }
+        wake.notify_all();
+    }
+}
+
+inline bool ThreadPool::take(WorkDeque &deque, int worker, bool back, Task &task) {
+    std::lock_guard<std::mutex> guard(deque.lock);
+    if (deque.tasks.empty()) return false;
+
+    if (back) {
+        task = deque.tasks.back();
+        deque.tasks.pop_back();
+        return true;
+    }
+
+    // a call limited to fewer threads is only stolen by the workers it admits
+    for (auto it = deque.tasks.begin(); it != deque.tasks.end(); ++it) {
+        if (!it->job->admits(worker)) continue;
+        task = *it;
+        deque.tasks.erase(it);
+        return true;
+    }
+    return false;
+}
+
+inline bool ThreadPool::find(int worker, Task &task) {
+    if (worker >= 0 && take(deques[worker], worker, true, task)) return true;
+    if (take(injection, worker, false, task)) return true;
+
+    const int count = (int) workerCount;
+    for (int i = 1; i <= count; i++) {
+        const int victim = (worker + i + count) % count;
+        if (victim != worker && take(deques[victim], worker, false, task)) return true;
+    }
+    return false;
+}
+
+inline void ThreadPool::execute(const Task &task, int worker) {
+    Job &job = *task.job;
+    size_t first = task.first, last = task.last;
+    while (last - first > job.grain) {
+        const size_t middle = first + (last - first) / 2;
+        push(Task{&job, middle, last}, worker);
+        last = middle;
+    }
+
+    if (!job.failed.load(std::memory_order_relaxed)) {
+        try {
+            job.run(job.body, first, last);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(job.errorLock);
+            if (!job.error) job.error = std::current_exception();
+            job.failed.store(true);
+        }
+    }
+
+    // last access to the job: once remaining reaches 0 the caller may return and destroy it
+    job.remaining.fetch_sub(last - first, std::memory_order_acq_rel);
+}
+
+inline void ThreadPool::workerLoop(int worker) {
+    identity() = Identity{this, worker};
+
+    Task task{};
+    while (true) {
+        const uint64_t seen = pushes.load();
+        if (find(worker, task)) {
+            execute(task, worker);
+            continue;
+        }
+
+        // sleep until something new is pushed: what is left may belong to calls limited to other threads
+        std::unique_lock<std::mutex> lock(sleepLock);
+        sleeping.fetch_add(1);
+        wake.wait(lock, [&]() { return stopping || pushes.load() != seen; });
+        sleeping.fetch_sub(1);
+        if (stopping) return;
+    }
+}
+
+inline void ThreadPool::runJob(Job &job, size_t begin, size_t end) {
+    const int worker = self();
+    execute(Task{&job, begin, end}, worker);
+
+    // help with any admitted task until every slice of this call is done
+    Task task{};
+    while (job.remaining.load(std::memory_order_acquire) != 0) {
+        if (find(worker, task)) execute(task, worker);
+        else std::this_thread::yield();
+    }
+
+    if (job.error) std::rethrow_exception(job.error);
+}
+
+template<class Body>
+void ThreadPool::parallelFor(size_t begin, size_t end, Body body, const ParallelOptions &options) {
+    if (begin >= end) return;
+
+    const unsigned threads = options.threads == 0 ? getThreadCount() : std::min(options.threads, getThreadCount());
+    const size_t size = end - begin;
+    const size_t grain = options.grain != 0 ? options.grain : std::max<size_t>(1, size / (size_t(threads) * 16));
+    if (threads <= 1 || size <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    Job job;
+    job.run = [](void *callable, size_t first, size_t last) { (*static_cast<Body *>(callable))(first, last); };
+    job.body = &body;
+    job.grain = grain;
+    job.limit = threads;
+    job.owner = self();
+    job.remaining.store(size);
+    runJob(job, begin, end);
+}
+
+template<class V, class Map, class Combine>
+V ThreadPool::parallelReduce(size_t begin, size_t end, V identity, Map map, Combine combine,
+                             const ParallelOptions &options) {
+    if (begin >= end) return identity;
+
+    const unsigned threads = options.threads == 0 ? getThreadCount() : std::min(options.threads, getThreadCount());
+    const size_t size = end - begin;
+    const size_t grain = options.grain != 0 ? options.grain : std::max<size_t>(1, size / (size_t(threads) * 16));
+    const size_t slices = (size + grain - 1) / grain;
+
+    std::vector<V> partial(slices, identity);
+    ParallelOptions perSlice;
+    perSlice.threads = threads;
+    perSlice.grain = 1;
+    parallelFor(0, slices, [&](size_t first, size_t last) {
+        for (size_t s = first; s < last; s++) {
+            const size_t from = begin + s * grain;
+            partial[s] = map(from, std::min(end, from + grain));
+        }
+    }, perSlice);
+
+    V result = identity;
+    for (auto &value : partial) result = combine(result, value);
+    return result;
+}
+
+#endif //GRAPHALGORITHM_THREADPOOL_HPP
@@ -29,7 +29,8 @@ int main() {
     graph.addEdge("Na", "Pl", 4);
 
 
-   cout << graph.toDot() << endl;
+    graph.writeDot(cout);
+    cout << endl;
 
     graphAlgorithm.breadthFirstSearch("H");
     cout << (graphAlgorithm.hasPathTo("Pl") ? "SIM" : "NÃO") << endl;
@@ -44,6 +45,7 @@ int main() {
     auto *g = new Graph<string>();
     graphAlgorithm.prim(g, "H");
 
-    cout << endl << g->toDot() << endl;
+    cout << endl;
+    g->writeDot(cout);
     return 0;
 }
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "ConcurrentGraphBuilder.hpp"
+#include "GraphBuilder.hpp"
+
+using namespace std;
+
+// Usage: build_bench [edges] [max threads]
+// Builds the same random graph with per-edge addEdge calls, with GraphBuilder and with
+// ConcurrentGraphBuilder fed by 1, 2, 4... threads, and reports edges/s. The concurrent runs
+// are repeated on a skewed copy where one hub vertex is the origin of a quarter of the edges.
+
+template<class Build>
+static void measure(const char *name, size_t edges, Build build) {
+    auto start = chrono::steady_clock::now();
+    size_t stored = build();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    printf("%-24s %10zu edges %12zu stored %9.3f s %12.0f edges/s\n",
+           name, edges, stored, elapsed.count(), edges / elapsed.count());
+}
+
+int main(int argc, char **argv) {
+    size_t edges = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    uint32_t vertices = (uint32_t) (edges / 8 + 1);
+
+    mt19937_64 random(7);
+    vector<tuple<uint32_t, uint32_t, float>> input;
+    input.reserve(edges);
+    for (size_t i = 0; i < edges; i++)
+        input.emplace_back(random() % vertices, random() % vertices, (float) (random() % 1000));
+
+    measure("Graph::addEdge", edges, [&]() {
+        Graph<uint32_t, float> graph;
+        for (const auto &[from, to, weight] : input) graph.addEdge(from, to, weight);
+        return graph.getEdges().size();
+    });
+
+    measure("GraphBuilder (graph)", edges, [&]() {
+        GraphBuilder<uint32_t, float> builder;
+        builder.reserve(edges);
+        for (const auto &[from, to, weight] : input) builder.addEdge(from, to, weight);
+        return builder.buildGraph().getEdges().size();
+    });
+
+    measure("Digraph::addEdge", edges, [&]() {
+        Digraph<uint32_t, float> graph;
+        for (const auto &[from, to, weight] : input) graph.addEdge(from, to, weight);
+        return graph.getEdges().size();
+    });
+
+    measure("GraphBuilder (digraph)", edges, [&]() {
+        GraphBuilder<uint32_t, float> builder;
+        builder.reserve(edges);
+        for (const auto &[from, to, weight] : input) builder.addEdge(from, to, weight);
+        return builder.buildDigraph().getEdges().size();
+    });
+
+    // the same edges with a quarter of them moved out of vertex 0, a hub every producer feeds
+    vector<tuple<uint32_t, uint32_t, float>> skewed = input;
+    for (size_t i = 0; i < skewed.size(); i += 4) get<0>(skewed[i]) = 0;
+
+    unsigned maxThreads = argc > 2 ? (unsigned) strtoul(argv[2], nullptr, 10) : thread::hardware_concurrency();
+    for (const auto &[label, edgesIn] : {make_pair("uniform", &input), make_pair("hub", &skewed)}) {
+        for (unsigned threads = 1; threads <= max(1u, maxThreads); threads *= 2) {
+            ConcurrentGraphBuilder<uint32_t, float> builder(threads);
+            builder.reserve(edges);
+
+            char name[64];
+            snprintf(name, sizeof(name), "ingest %s x%u", label, threads);
+            measure(name, edges, [&, edgesIn = edgesIn]() {
+                vector<thread> producers;
+                for (unsigned t = 0; t < threads; t++) {
+                    producers.emplace_back([&, t]() {
+                        for (size_t i = t; i < edgesIn->size(); i += threads) {
+                            const auto &[from, to, weight] = (*edgesIn)[i];
+                            builder.addEdge(from, to, weight);
+                        }
+                    });
+                }
+                for (auto &producer : producers) producer.join();
+                return builder.size();
+            });
+
+            snprintf(name, sizeof(name), "%s to CSR x%u", label, threads);
+            measure(name, edges, [&]() { return builder.buildCsr(false).getEdgeCount(); });
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,598 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <random>
+#include <stack>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CentralityAlgorithm.hpp"
+#include "CsrAlgorithm.hpp"
+#include "DagAlgorithm.hpp"
+#include "FlowAlgorithm.hpp"
+#include "GraphAlgorithm.hpp"
+#include "GraphBuilder.hpp"
+#include "GraphGenerator.hpp"
+#include "MatchingAlgorithm.hpp"
+#include "MinCostFlowAlgorithm.hpp"
+#include "PageRankAlgorithm.hpp"
+#include "PairHeap.hpp"
+#include "RadixHeap.hpp"
+
+using namespace std;
+
+// Usage: graph_bench [--scale S] [--edge-factor F] [--min-time SECONDS] [--filter TEXT] [--out FILE]
+//
+// Generates R-MAT, Graph500 Kronecker, Erdos-Renyi, 2D grid, power-law, Barabasi-Albert,
+// Watts-Strogatz and random geometric graphs with 2^S vertices and about F * 2^S edges, times
+// construction, BFS, DFS, Dijkstra and Prim on each, plus heap push/pop, and writes the results
+// as JSON (Google Benchmark layout) to FILE or stdout. A readable table goes to stderr.
+//
+// The memory_* entries compare the bytes held by Graph, CsrGraph and the search scratch state;
+// "--scale 20 --filter memory" compares them at 16M edges without running the timed benchmarks.
+//
+// The *_dense entries run BFS and DFS on an Erdos-Renyi graph with 2^(S/2+3) vertices and a
+// quarter of all pairs as edges, next to the textbook variants that mark a vertex when it is
+// popped; their frontier_peak field is the largest queue or stack each one held. The dag_*
+// entries orient the Erdos-Renyi edges from lower to higher id and compare the topological sorts
+// and linear-time DAG paths with dijkstra on the same Digraph. The maxflow_* entries run both
+// maximum flow engines on a directed R-MAT and grid graph, from the vertex with the most
+// out-edges to the one with the most in-edges. The transport_* entries solve a bipartite
+// transport problem, 2^(S/2+2) suppliers and as many consumers, 8 random routes per supplier,
+// with both min-cost flow engines. The matching_* entries check bipartiteness and match a random
+// bipartite graph with 2^S vertices a side and F/2 edges per left vertex, whose right ends are
+// skewed toward low ids so that greedy leaves work for the augmenting phases. The pagerank_*
+// entries run PageRank to convergence on the directed R-MAT graph and personalized PageRank by
+// forward push from its busiest vertex; ops are vertices for the former, pushes for the latter.
+// The betweenness_* entries estimate the betweenness of the undirected R-MAT graph from 256
+// sampled sources, by BFS and by Dijkstra; ops are sources, error_bound the normalized additive
+// bound at 95% confidence.
+
+using Weight = uint32_t;
+using Arc = CsrGraph<Weight>::Arc;
+
+struct Settings {
+    unsigned scale = 14;
+    size_t edgeFactor = 16;
+    double minTime = 0.2;
+    string filter;
+    string out;
+};
+
+struct Footprint {
+    string name;
+    size_t edges;
+    MemoryUsage usage;
+};
+
+struct Result {
+    string name;
+    size_t iterations;
+    double nsPerIteration;
+    double nsPerOp;
+    double edgesPerSecond;
+    long peakRssBytes;
+    vector<pair<string, double>> counters;
+};
+
+// Linux only: writing 5 to clear_refs resets the VmHWM high-water mark of the process
+static void resetPeakRss() {
+    ofstream clear("/proc/self/clear_refs");
+    if (clear) clear << "5";
+}
+
+static long peakRssBytes() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0) return strtol(line.c_str() + 6, nullptr, 10) * 1024;
+    return -1;
+}
+
+class Runner {
+    const Settings &settings;
+    vector<Result> results;
+    vector<Footprint> footprints;
+
+public:
+    explicit Runner(const Settings &settings) : settings(settings) {}
+
+    /**
+     * Calls body once untimed, so that the copies and caches built by a first query stay out of
+     * the timings, then repeats it until minTime is spent; edges and ops are the work of a single call.
+     *
+     * @return False if the benchmark was filtered out.
+     */
+    bool run(const string &name, size_t edges, size_t ops, const function<void()> &body) {
+        if (!settings.filter.empty() && name.find(settings.filter) == string::npos) return false;
+
+        body();
+        resetPeakRss();
+        size_t iterations = 0;
+        chrono::duration<double> elapsed{};
+        auto start = chrono::steady_clock::now();
+        do {
+            body();
+            iterations++;
+            elapsed = chrono::steady_clock::now() - start;
+        } while (elapsed.count() < settings.minTime);
+
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        result.nsPerIteration = elapsed.count() * 1e9 / iterations;
+        result.nsPerOp = ops != 0 ? result.nsPerIteration / ops : 0;
+        result.edgesPerSecond = edges != 0 ? edges * iterations / elapsed.count() : 0;
+        result.peakRssBytes = peakRssBytes();
+        results.push_back(result);
+
+        fprintf(stderr, "%-36s %8zu it %14.0f ns/it %10.2f ns/op %14.0f edges/s %8.1f MB\n",
+                name.c_str(), iterations, result.nsPerIteration, result.nsPerOp, result.edgesPerSecond,
+                result.peakRssBytes / (1024.0 * 1024.0));
+        return true;
+    }
+
+    /**
+     * Attaches a named value to the last benchmark run, written as an extra JSON field.
+     */
+    void counter(const string &name, double value) {
+        if (results.empty()) return;
+        results.back().counters.emplace_back(name, value);
+        fprintf(stderr, "  %-34s %s %.10g\n", results.back().name.c_str(), name.c_str(), value);
+    }
+
+    /**
+     * Records the bytes held by one representation of a graph with the given number of edges.
+     */
+    void measure(const string &name, size_t edges, const MemoryUsage &usage) {
+        if (!settings.filter.empty() && name.find(settings.filter) == string::npos) return;
+
+        footprints.push_back({name, edges, usage});
+        fprintf(stderr, "%-36s %14zu bytes %8.2f bytes/edge (buckets %zu, nodes %zu, elements %zu)\n",
+                name.c_str(), usage.total(), edges != 0 ? (double) usage.total() / edges : 0.0,
+                usage.buckets, usage.nodes, usage.elements);
+    }
+
+    void writeJson(FILE *out) const {
+        char date[64];
+        time_t now = time(nullptr);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+        fprintf(out, "{\n  \"context\": {\n");
+        fprintf(out, "    \"date\": \"%s\",\n", date);
+        fprintf(out, "    \"num_cpus\": %u,\n", thread::hardware_concurrency());
+        fprintf(out, "    \"scale\": %u,\n", settings.scale);
+        fprintf(out, "    \"edge_factor\": %zu,\n", settings.edgeFactor);
+#ifdef NDEBUG
+        fprintf(out, "    \"library_build_type\": \"release\"\n");
+#else
+        fprintf(out, "    \"library_build_type\": \"debug\"\n");
+#endif
+        fprintf(out, "  },\n  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &r = results[i];
+            fprintf(out, "    {\n");
+            fprintf(out, "      \"name\": \"%s\",\n", r.name.c_str());
+            fprintf(out, "      \"iterations\": %zu,\n", r.iterations);
+            fprintf(out, "      \"real_time\": %.1f,\n", r.nsPerIteration);
+            fprintf(out, "      \"time_unit\": \"ns\",\n");
+            fprintf(out, "      \"ns_per_op\": %.3f,\n", r.nsPerOp);
+            fprintf(out, "      \"edges_per_second\": %.1f,\n", r.edgesPerSecond);
+            fprintf(out, "      \"peak_rss_bytes\": %ld%s\n", r.peakRssBytes, r.counters.empty() ? "" : ",");
+            for (size_t c = 0; c < r.counters.size(); c++)
+                fprintf(out, "      \"%s\": %.10g%s\n", r.counters[c].first.c_str(), r.counters[c].second,
+                        c + 1 < r.counters.size() ? "," : "");
+            fprintf(out, "    }%s\n", i + 1 < results.size() ? "," : "");
+        }
+        fprintf(out, "  ],\n  \"memory\": [\n");
+        for (size_t i = 0; i < footprints.size(); i++) {
+            const Footprint &f = footprints[i];
+            fprintf(out, "    {\n");
+            fprintf(out, "      \"name\": \"%s\",\n", f.name.c_str());
+            fprintf(out, "      \"edges\": %zu,\n", f.edges);
+            fprintf(out, "      \"bytes\": %zu,\n", f.usage.total());
+            fprintf(out, "      \"bucket_bytes\": %zu,\n", f.usage.buckets);
+            fprintf(out, "      \"node_bytes\": %zu,\n", f.usage.nodes);
+            fprintf(out, "      \"element_bytes\": %zu\n", f.usage.elements);
+            fprintf(out, "    }%s\n", i + 1 < footprints.size() ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    }
+};
+
+// only with -DGRAPHALGORITHM_INSTRUMENTATION=ON: what the last query of a benchmark did
+static void printStats(const string &name, const QueryStats &stats) {
+    if (!Instrumentation::ENABLED) return;
+    fprintf(stderr, "  %-34s settled %zu scanned %zu push %zu pop %zu stale %zu peak %zu probes/lookup %.2f"
+                    " setup %.3f ms search %.3f ms output %.3f ms\n",
+            name.c_str(), (size_t) stats.verticesSettled, (size_t) stats.edgesScanned, (size_t) stats.heapPushes,
+            (size_t) stats.heapPops, (size_t) stats.stalePops, (size_t) stats.peakHeapSize,
+            stats.adjacencyLookups != 0 ? (double) stats.hashProbes / stats.adjacencyLookups : 0.0,
+            stats.phaseTime[QueryStats::SETUP].count() / 1e6, stats.phaseTime[QueryStats::SEARCH].count() / 1e6,
+            stats.phaseTime[QueryStats::OUTPUT].count() / 1e6);
+}
+
+static void benchGraph(Runner &runner, const string &family, const Settings &settings,
+                       size_t vertices, const vector<Arc> &arcs) {
+    const string suffix = "/" + family + "/scale:" + to_string(settings.scale);
+
+    runner.run("construct_csr" + suffix, arcs.size(), arcs.size(), [&]() {
+        auto csr = CsrGraph<Weight>::fromArcs(vertices, arcs, false);
+        if (csr.getEdgeCount() == 0) abort();
+    });
+
+    runner.run("construct_graph" + suffix, arcs.size(), arcs.size(), [&]() {
+        GraphBuilder<uint32_t, Weight> builder;
+        builder.reserve(arcs.size());
+        for (const Arc &arc : arcs) builder.addEdge(arc.from, arc.to, arc.weight);
+        if (builder.buildGraph().isEmpty()) abort();
+    });
+
+    GraphBuilder<uint32_t, Weight> builder;
+    for (const Arc &arc : arcs) builder.addEdge(arc.from, arc.to, arc.weight);
+    Graph<uint32_t, Weight> graph = builder.buildGraph();
+    const CsrGraph<Weight> csr = CsrGraph<Weight>::fromArcs(vertices, arcs, false);
+
+    const uint32_t source = arcs.front().from;
+    const size_t edges = graph.getEdges().size();
+    const size_t order = graph.getVertices().size();
+    GraphAlgorithm<uint32_t, Weight> algorithm(&graph);
+
+    runner.run("bfs" + suffix, edges, order, [&]() { algorithm.breadthFirstSearch(source); });
+    runner.run("dfs" + suffix, edges, order, [&]() { algorithm.depthFirstSearch(source); });
+    if (runner.run("dijkstra" + suffix, edges, order, [&]() { algorithm.dijkstra(source); }))
+        printStats("dijkstra" + suffix, algorithm.getStats());
+
+    CsrAlgorithm<Weight> csrAlgorithm(&csr);
+    if (runner.run("dijkstra_csr" + suffix, csr.getEdgeCount(), csr.getVertexCount(),
+                   [&]() { csrAlgorithm.dijkstra(source); }))
+        printStats("dijkstra_csr" + suffix, csrAlgorithm.getStats());
+
+    if (runner.run("prim" + suffix, edges, order, [&]() {
+        Graph<uint32_t, Weight> tree;
+        algorithm.prim(&tree, source);
+    }))
+        printStats("prim" + suffix, algorithm.getStats());
+
+    runner.measure("memory_graph" + suffix, edges, graph.memoryUsage());
+    runner.measure("memory_csr" + suffix, csr.getEdgeCount(), csr.memoryUsage());
+
+    // scratch state of a single-source search, sized by a last untimed run
+    algorithm.dijkstra(source);
+    csrAlgorithm.dijkstra(source);
+    runner.measure("memory_scratch" + suffix, edges, algorithm.memoryUsage());
+    runner.measure("memory_scratch_csr" + suffix, csr.getEdgeCount(), csrAlgorithm.memoryUsage());
+}
+
+// tracks discovered - finished vertices, that is the queue of a BFS or the current path of a DFS
+struct FrontierPeak : TraversalVisitor<uint32_t, Weight> {
+    size_t size = 0;
+    size_t peak = 0;
+
+    VisitAction onDiscover(const uint32_t &, size_t) {
+        if (++size > peak) peak = size;
+        return VisitAction::CONTINUE;
+    }
+
+    VisitAction onFinish(const uint32_t &) {
+        size--;
+        return VisitAction::CONTINUE;
+    }
+};
+
+// the variants the library used to have: mark on pop, so a vertex is pushed once per edge reaching it
+static size_t bfsMarkOnPop(Graph<uint32_t, Weight> &graph, uint32_t source, vector<bool> &marked) {
+    fill(marked.begin(), marked.end(), false);
+    queue<uint32_t> frontier;
+    frontier.push(source);
+    size_t peak = 1;
+    while (!frontier.empty()) {
+        const uint32_t current = frontier.front();
+        frontier.pop();
+        if (marked[current]) continue;
+        marked[current] = true;
+        for (const auto &edge : graph[current])
+            if (!marked[edge.getTo()]) frontier.push(edge.getTo());
+        peak = max(peak, frontier.size());
+    }
+    return peak;
+}
+
+static size_t dfsMarkOnPop(Graph<uint32_t, Weight> &graph, uint32_t source, vector<bool> &marked) {
+    fill(marked.begin(), marked.end(), false);
+    stack<uint32_t> frontier;
+    frontier.push(source);
+    size_t peak = 1;
+    while (!frontier.empty()) {
+        const uint32_t current = frontier.top();
+        frontier.pop();
+        if (marked[current]) continue;
+        marked[current] = true;
+        for (const auto &edge : graph[current])
+            if (!marked[edge.getTo()]) frontier.push(edge.getTo());
+        peak = max(peak, frontier.size());
+    }
+    return peak;
+}
+
+static void benchTraversal(Runner &runner, const Settings &settings) {
+    const size_t vertices = size_t(1) << (settings.scale / 2 + 3);
+    GeneratorOptions options;
+    const vector<Arc> arcs = GraphGenerator<Weight>::erdosRenyi(vertices, vertices * vertices / 4, options);
+    const string suffix = "/erdos_renyi_dense/n:" + to_string(vertices);
+
+    GraphBuilder<uint32_t, Weight> builder;
+    for (const Arc &arc : arcs) builder.addEdge(arc.from, arc.to, arc.weight);
+    Graph<uint32_t, Weight> graph = builder.buildGraph();
+    const uint32_t source = arcs.front().from;
+    const size_t edges = graph.getEdges().size();
+    const size_t order = graph.getVertices().size();
+
+    GraphAlgorithm<uint32_t, Weight> algorithm(&graph);
+    vector<bool> marked(vertices);
+    size_t peak = 0;
+
+    if (runner.run("bfs_dense" + suffix, edges, order, [&]() { algorithm.breadthFirstSearch(source); })) {
+        FrontierPeak visitor;
+        algorithm.breadthFirstVisit(source, visitor);
+        runner.counter("frontier_peak", visitor.peak);
+    }
+    if (runner.run("bfs_dense_mark_on_pop" + suffix, edges, order,
+                   [&]() { peak = bfsMarkOnPop(graph, source, marked); }))
+        runner.counter("frontier_peak", peak);
+
+    if (runner.run("dfs_dense" + suffix, edges, order, [&]() { algorithm.depthFirstSearch(source); })) {
+        FrontierPeak visitor;
+        algorithm.depthFirstVisit(source, visitor);
+        runner.counter("frontier_peak", visitor.peak);
+    }
+    if (runner.run("dfs_dense_mark_on_pop" + suffix, edges, order,
+                   [&]() { peak = dfsMarkOnPop(graph, source, marked); }))
+        runner.counter("frontier_peak", peak);
+}
+
+static void benchDag(Runner &runner, const Settings &settings) {
+    const size_t vertices = size_t(1) << settings.scale;
+    GeneratorOptions options;
+    const string suffix = "/erdos_renyi/scale:" + to_string(settings.scale);
+
+    Digraph<uint32_t, Weight> dag;
+    for (const Arc &arc : GraphGenerator<Weight>::erdosRenyi(vertices, vertices * settings.edgeFactor, options))
+        if (arc.from != arc.to) dag.addEdge(min(arc.from, arc.to), max(arc.from, arc.to), arc.weight);
+    const uint32_t source = 0;
+    const size_t edges = dag.getEdges().size();
+    const size_t order = dag.getVertices().size();
+
+    DagAlgorithm<uint32_t, Weight> algorithm(&dag);
+    runner.run("dag_topological_sort" + suffix, edges, order, [&]() { algorithm.topologicalSort(); });
+    runner.run("dag_topological_sort_parallel" + suffix, edges, order, [&]() { algorithm.parallelTopologicalSort(); });
+    runner.run("dag_shortest" + suffix, edges, order, [&]() { algorithm.shortestPaths(source); });
+    runner.run("dag_critical_path" + suffix, edges, order, [&]() { algorithm.criticalPath(); });
+
+    GraphAlgorithm<uint32_t, Weight, Digraph<uint32_t, Weight>> general(&dag);
+    runner.run("dag_dijkstra" + suffix, edges, order, [&]() { general.dijkstra(source); });
+}
+
+static void benchFlow(Runner &runner, const Settings &settings, const string &family, const vector<Arc> &arcs) {
+    const string suffix = "/" + family + "/scale:" + to_string(settings.scale);
+
+    Digraph<uint32_t, Weight> network;
+    for (const Arc &arc : arcs)
+        if (arc.from != arc.to) network.addEdge(arc.from, arc.to, arc.weight);
+    // the busiest tail and head, so that the cut is not just the edges around a leaf
+    vector<size_t> outDegree, inDegree;
+    for (const Arc &arc : arcs) {
+        if (arc.from == arc.to) continue;
+        const size_t needed = max(arc.from, arc.to) + size_t(1);
+        if (outDegree.size() < needed) outDegree.resize(needed), inDegree.resize(needed);
+        outDegree[arc.from]++;
+        inDegree[arc.to]++;
+    }
+    const uint32_t source = (uint32_t) (max_element(outDegree.begin(), outDegree.end()) - outDegree.begin());
+    inDegree[source] = 0;
+    const uint32_t sink = (uint32_t) (max_element(inDegree.begin(), inDegree.end()) - inDegree.begin());
+    const size_t edges = network.getEdges().size();
+    const size_t order = network.getVertices().size();
+
+    FlowAlgorithm<uint32_t, Weight> algorithm(&network);
+    runner.run("maxflow_dinic" + suffix, edges, order, [&]() { algorithm.dinic(source, sink); });
+    runner.run("maxflow_push_relabel" + suffix, edges, order, [&]() { algorithm.pushRelabel(source, sink); });
+}
+
+static void benchTransport(Runner &runner, const Settings &settings) {
+    const uint32_t side = uint32_t(1) << (settings.scale / 2 + 2);
+    const uint32_t source = 2 * side, sink = 2 * side + 1;
+    const string suffix = "/bipartite/n:" + to_string(side);
+
+    // suppliers are [0, side), consumers [side, 2 * side); supply and demand are the capacities
+    // of the edges from the source and to the sink, routes are unbounded
+    mt19937_64 random(settings.scale);
+    vector<uint64_t> amount(2 * side);
+    for (auto &units : amount) units = 1 + random() % 100;
+    Digraph<uint32_t, Weight> network;
+    for (uint32_t supplier = 0; supplier < side; supplier++) {
+        network.addEdge(source, supplier, 0);
+        for (int route = 0; route < 8; route++)
+            network.addEdge(supplier, side + (uint32_t) (random() % side), 1 + (Weight) (random() % 1000));
+    }
+    for (uint32_t consumer = side; consumer < 2 * side; consumer++) network.addEdge(consumer, sink, 0);
+
+    auto capacity = [&](const Edge<uint32_t, Weight> &edge) -> uint64_t {
+        if (edge.getFrom() == source) return amount[edge.getTo()];
+        if (edge.getTo() == sink) return amount[edge.getFrom()];
+        return uint64_t(1) << 32;
+    };
+    const size_t edges = network.getEdges().size();
+    const size_t order = network.getVertices().size();
+
+    MinCostFlowAlgorithm<uint32_t, Weight> algorithm(&network, capacity);
+    runner.run("transport_ssp" + suffix, edges, order, [&]() { algorithm.successiveShortestPaths(source, sink); });
+    runner.run("transport_cost_scaling" + suffix, edges, order, [&]() { algorithm.costScaling(source, sink); });
+}
+
+static void benchMatching(Runner &runner, const Settings &settings) {
+    const uint32_t side = uint32_t(1) << settings.scale;
+    const string suffix = "/bipartite/n:" + to_string(side);
+
+    // left vertices are [0, side), right ones [side, 2 * side); the square of a uniform draw
+    // crowds the right ends at the front
+    mt19937_64 random(settings.scale);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    vector<Arc> arcs;
+    arcs.reserve(side * max<size_t>(settings.edgeFactor / 2, 1));
+    for (uint32_t left = 0; left < side; left++) {
+        for (size_t i = 0; i < max<size_t>(settings.edgeFactor / 2, 1); i++) {
+            const double draw = uniform(random);
+            arcs.push_back({left, side + min(side - 1, (uint32_t) (draw * draw * side)), 1});
+        }
+    }
+    Graph<uint32_t, Weight> graph;
+    graph.bulkInsert(arcs);
+    const size_t edges = arcs.size();
+    const size_t order = graph.getVertices().size();
+
+    MatchingAlgorithm<uint32_t, Weight> algorithm(&graph);
+    runner.run("matching_bipartite_check" + suffix, edges, order, [&]() { algorithm.isBipartite(); });
+    if (runner.run("matching_greedy" + suffix, edges, order, [&]() { algorithm.greedyMatching(); }))
+        runner.counter("matching_size", (double) algorithm.getMatchingSize());
+    if (runner.run("matching_hopcroft_karp" + suffix, edges, order, [&]() { algorithm.hopcroftKarp(); }))
+        runner.counter("matching_size", (double) algorithm.getMatchingSize());
+    if (runner.run("matching_hopcroft_karp_cold" + suffix, edges, order, [&]() { algorithm.hopcroftKarp(false); }))
+        runner.counter("matching_size", (double) algorithm.getMatchingSize());
+}
+
+static void benchRank(Runner &runner, const Settings &settings, const string &family, const vector<Arc> &arcs) {
+    const string suffix = "/" + family + "/scale:" + to_string(settings.scale);
+
+    Digraph<uint32_t, Weight> graph;
+    graph.bulkInsert(arcs);
+    vector<size_t> outDegree;
+    for (const Arc &arc : arcs) {
+        if (outDegree.size() <= arc.from) outDegree.resize(arc.from + size_t(1));
+        outDegree[arc.from]++;
+    }
+    const uint32_t seed = (uint32_t) (max_element(outDegree.begin(), outDegree.end()) - outDegree.begin());
+    const size_t edges = graph.getEdges().size();
+    const size_t order = graph.getVertices().size();
+
+    PageRankAlgorithm<uint32_t, Weight> algorithm(&graph);
+    PageRankOptions options;
+    options.tolerance = 1e-6;
+    if (runner.run("pagerank" + suffix, edges, order, [&]() { algorithm.pageRank(options); })) {
+        runner.counter("iterations", (double) algorithm.getIterations());
+        runner.counter("residual", algorithm.getResidual());
+    }
+    algorithm.personalizedPageRank(seed, options);
+    if (runner.run("pagerank_ppr" + suffix, edges, algorithm.getIterations(),
+                   [&]() { algorithm.personalizedPageRank(seed, options); })) {
+        runner.counter("pushes", (double) algorithm.getIterations());
+        runner.counter("residual", algorithm.getResidual());
+    }
+}
+
+static void benchBetweenness(Runner &runner, const Settings &settings, const string &family, const vector<Arc> &arcs) {
+    const string suffix = "/" + family + "/scale:" + to_string(settings.scale);
+
+    Graph<uint32_t, Weight> graph;
+    graph.bulkInsert(arcs);
+    const size_t edges = graph.getEdges().size();
+
+    CentralityAlgorithm<uint32_t, Weight> algorithm(&graph);
+    BetweennessOptions options;
+    options.normalized = true;
+    options.samples = 256;
+    for (bool weighted : {false, true}) {
+        options.weighted = weighted;
+        const string name = string(weighted ? "betweenness_sampled_dijkstra" : "betweenness_sampled_bfs") + suffix;
+        if (runner.run(name, edges * options.samples, options.samples, [&]() { algorithm.betweenness(options); }))
+            runner.counter("error_bound", algorithm.getErrorBound());
+    }
+}
+
+static void benchHeaps(Runner &runner, const Settings &settings) {
+    const size_t count = size_t(1) << settings.scale;
+    mt19937_64 random(settings.scale);
+    vector<uint64_t> keys(count);
+    for (auto &key : keys) key = random() % (count * 16);
+    const string suffix = "/n:" + to_string(count);
+
+    runner.run("heap_pairheap" + suffix, 0, 2 * count, [&]() {
+        PairHeap<uint32_t, uint64_t> heap;
+        PairHeap<uint32_t, uint64_t>::minPairHeap(heap);
+        for (size_t i = 0; i < count; i++) heap.add((uint32_t) i, keys[i]);
+        while (!heap.isEmpty()) heap.pool();
+    });
+
+    runner.run("heap_radixheap" + suffix, 0, 2 * count, [&]() {
+        RadixHeap<uint32_t> heap;
+        for (size_t i = 0; i < count; i++) heap.add((uint32_t) i, keys[i]);
+        while (!heap.isEmpty()) heap.pool();
+    });
+}
+
+static bool parse(int argc, char **argv, Settings &settings) {
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--scale") == 0 && hasValue) settings.scale = (unsigned) strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--edge-factor") == 0 && hasValue) settings.edgeFactor = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--min-time") == 0 && hasValue) settings.minTime = strtod(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--filter") == 0 && hasValue) settings.filter = argv[++i];
+        else if (strcmp(argv[i], "--out") == 0 && hasValue) settings.out = argv[++i];
+        else return false;
+    }
+    return settings.scale > 0 && settings.scale < 32;
+}
+
+int main(int argc, char **argv) {
+    Settings settings;
+    if (!parse(argc, argv, settings)) {
+        fprintf(stderr, "usage: %s [--scale S] [--edge-factor F] [--min-time SECONDS] [--filter TEXT] [--out FILE]\n",
+                argv[0]);
+        return 2;
+    }
+
+    const size_t vertices = size_t(1) << settings.scale;
+    const size_t edges = vertices * settings.edgeFactor;
+    const size_t rows = size_t(1) << (settings.scale / 2);
+    const size_t columns = vertices / rows;
+
+    GeneratorOptions options;
+    Runner runner(settings);
+    benchGraph(runner, "rmat", settings, vertices, GraphGenerator<Weight>::rmat(settings.scale, edges, options));
+    benchGraph(runner, "erdos_renyi", settings, vertices, GraphGenerator<Weight>::erdosRenyi(vertices, edges, options));
+    benchGraph(runner, "grid", settings, vertices, GraphGenerator<Weight>::grid(rows, columns, options));
+    benchGraph(runner, "power_law", settings, vertices, GraphGenerator<Weight>::powerLaw(vertices, edges, options));
+    benchGraph(runner, "kronecker", settings, vertices,
+               GraphGenerator<Weight>::kronecker(settings.scale, settings.edgeFactor, options));
+    benchGraph(runner, "barabasi_albert", settings, vertices,
+               GraphGenerator<Weight>::barabasiAlbert(vertices, settings.edgeFactor, options));
+    benchGraph(runner, "watts_strogatz", settings, vertices,
+               GraphGenerator<Weight>::wattsStrogatz(vertices, 2 * settings.edgeFactor, 0.1, options));
+    benchGraph(runner, "geometric", settings, vertices,
+               GraphGenerator<Weight>::randomGeometric(vertices, sqrt(2.0 * settings.edgeFactor / (M_PI * vertices)), options));
+    benchTraversal(runner, settings);
+    benchDag(runner, settings);
+    benchFlow(runner, settings, "rmat", GraphGenerator<Weight>::rmat(settings.scale, edges, options));
+    benchFlow(runner, settings, "grid", GraphGenerator<Weight>::grid(rows, columns, options));
+    benchTransport(runner, settings);
+    benchMatching(runner, settings);
+    benchRank(runner, settings, "rmat", GraphGenerator<Weight>::rmat(settings.scale, edges, options));
+    benchBetweenness(runner, settings, "rmat", GraphGenerator<Weight>::rmat(settings.scale, edges, options));
+    benchHeaps(runner, settings);
+
+    FILE *out = settings.out.empty() ? stdout : fopen(settings.out.c_str(), "w");
+    if (out == nullptr) {
+        fprintf(stderr, "cannot write %s\n", settings.out.c_str());
+        return 1;
+    }
+    runner.writeJson(out);
+    if (out != stdout) fclose(out);
+    return 0;
+}
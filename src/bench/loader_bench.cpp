@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "GraphLoader.hpp"
+
+using namespace std;
+
+// Usage:
+//   loader_bench [edges] [threads]        generates an edge list, a .gr and a .mtx file and loads each
+//   loader_bench <file> [threads]         loads an existing file (format picked by extension)
+
+static void writeSynthetic(const string &dir, size_t vertices, size_t edges) {
+    FILE *list = fopen((dir + "/bench.txt").c_str(), "w");
+    FILE *dimacs = fopen((dir + "/bench.gr").c_str(), "w");
+    FILE *market = fopen((dir + "/bench.mtx").c_str(), "w");
+    if (list == nullptr || dimacs == nullptr || market == nullptr) {
+        cerr << "cannot write synthetic inputs to " << dir << endl;
+        exit(1);
+    }
+
+    fprintf(list, "# synthetic edge list\n");
+    fprintf(dimacs, "c synthetic DIMACS graph\np sp %zu %zu\n", vertices, edges);
+    fprintf(market, "%%%%MatrixMarket matrix coordinate real general\n%zu %zu %zu\n", vertices, vertices, edges);
+
+    mt19937_64 random(42);
+    uniform_int_distribution<size_t> vertex(0, vertices - 1);
+    uniform_real_distribution<double> weight(0.5, 1000.0);
+    for (size_t i = 0; i < edges; i++) {
+        size_t from = vertex(random), to = vertex(random);
+        double w = weight(random);
+        fprintf(list, "%zu %zu %.3f\n", from, to, w);
+        fprintf(dimacs, "a %zu %zu %zu\n", from + 1, to + 1, (size_t) w);
+        fprintf(market, "%zu %zu %.6e\n", from + 1, to + 1, w);
+    }
+
+    fclose(list);
+    fclose(dimacs);
+    fclose(market);
+}
+
+static void measure(const string &path, unsigned threads) {
+    GraphLoadOptions options;
+    options.threads = threads;
+
+    const int RUNS = 3;
+    double best = 1e300;
+    size_t vertices = 0, arcs = 0;
+    for (int run = 0; run < RUNS; run++) {
+        auto start = chrono::steady_clock::now();
+        auto csr = GraphLoader::load<double>(path, options);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        best = min(best, elapsed.count());
+        vertices = csr.getVertexCount();
+        arcs = csr.getEdgeCount();
+    }
+
+    double megabytes = filesystem::file_size(path) / (1024.0 * 1024.0);
+    printf("%-40s %10.1f MB %10zu vertices %12zu arcs %9.3f s %10.1f MB/s\n",
+           path.c_str(), megabytes, vertices, arcs, best, megabytes / best);
+}
+
+int main(int argc, char **argv) {
+    unsigned threads = argc > 2 ? (unsigned) strtoul(argv[2], nullptr, 10) : 0;
+
+    if (argc > 1 && filesystem::exists(argv[1])) {
+        measure(argv[1], threads);
+        return 0;
+    }
+
+    size_t edges = argc > 1 ? strtoull(argv[1], nullptr, 10) : 5000000;
+    size_t vertices = edges / 8 + 1;
+    string dir = filesystem::temp_directory_path().string();
+
+    writeSynthetic(dir, vertices, edges);
+    for (const char *name : {"/bench.txt", "/bench.gr", "/bench.mtx"})
+        measure(dir + name, threads);
+
+    return 0;
+}